@@ -0,0 +1,55 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+#include "levenshtein.h"
+using namespace std;
+
+/**
+ * Burkhard-Keller tree over strings under Levenshtein distance
+ *
+ * Each child edge is labelled with its distance to the parent key. When a
+ * query at distance d from a node has radius r, the triangle inequality
+ * means only children whose edge label lies in [d - r, d + r] can match.
+ * Removal only marks an entry dead. The tree is rebuilt once dead entries
+ * outnumber live ones.
+ */
+template<typename V>
+class BKTree {
+public:
+    struct BKNode {
+        string key;
+        V value;
+        bool alive;
+        vector<pair<int, unique_ptr<BKNode>>> children;     // (distance to key, subtree)
+
+        BKNode(const string& k, const V& v) : key(k), value(v), alive(true) {}
+    };
+
+private:
+    unique_ptr<BKNode> root;
+    size_t liveCount;
+    size_t deadCount;
+
+    BKNode* findNode(const string& key) const;
+    void collectLive(unique_ptr<BKNode>& node, vector<pair<string, V>>& entries);
+    void rebuild();
+
+public:
+    BKTree();
+
+    bool insert(const string& key, const V& value);     // false if key already present
+    bool remove(const string& key);
+    const V* find(const string& key) const;
+
+    // Appends (distance, value) for every key within maxDistance of query.
+    // If visited is given, it receives the number of nodes whose distance was computed.
+    void search(const string& query, int maxDistance, vector<pair<int, V>>& results,
+                size_t* visited = nullptr) const;
+
+    size_t size() const { return liveCount; }
+    bool empty() const { return liveCount == 0; }
+    void clear();
+};
+
+#include "../solution/bk_tree.cpp"
@@ -0,0 +1,90 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <vector>
+#include <iostream>
+using namespace std;
+
+/**
+ * B+ tree template class
+ *
+ * Values live only in the leaves. Leaves are linked left to right, so range
+ * scans walk the leaves in order after a single descent. Each node keeps its
+ * keys in one contiguous array. The default fanout sizes that array to about
+ * four cache lines. Internal nodes also record how many pairs sit under each
+ * child, so counting and ranked access descend once instead of walking leaves.
+ */
+template<typename K, typename V>
+class BPlusTree {
+public:
+    struct BPlusNode {
+        bool isLeaf;
+        vector<K> keys;
+        vector<V> values;                           // leaves only, parallel to keys
+        vector<unique_ptr<BPlusNode>> children;     // internal nodes only, keys.size() + 1 entries
+        vector<size_t> counts;                      // internal nodes only, pairs under each child
+        BPlusNode* next;                            // next leaf in key order
+
+        BPlusNode(bool leaf) : isLeaf(leaf), next(nullptr) {}
+    };
+
+    static size_t defaultFanout() {
+        size_t fanout = 256 / sizeof(K);            // ~4 cache lines of keys per node
+        return fanout < 4 ? 4 : fanout;
+    }
+
+protected:
+    unique_ptr<BPlusNode> root;
+    size_t nodeCount;
+    size_t maxKeys;
+    size_t minKeys;
+    function<bool(const K&, const K&)> comparator;
+
+    size_t childIndex(const BPlusNode* node, const K& key) const;
+    size_t leafIndex(const BPlusNode* leaf, const K& key) const;
+    const BPlusNode* findLeaf(const K& key) const;
+    const BPlusNode* leftmostLeaf() const;
+    static size_t subtreeSize(const BPlusNode* node);
+    size_t rankOf(const K& key, bool inclusive) const;  // pairs with key < key (or <= key if inclusive)
+
+    // Returns the new right sibling (and its separator) when node had to split
+    unique_ptr<BPlusNode> insertHelper(BPlusNode* node, const K& key, const V& value, K& separator, bool& inserted);
+    bool removeHelper(BPlusNode* node, const K& key);
+    void fixUnderflow(BPlusNode* parent, size_t index);
+
+public:
+    BPlusTree(size_t fanout = defaultFanout());
+    BPlusTree(function<bool(const K&, const K&)> comp, size_t fanout = defaultFanout());
+    virtual ~BPlusTree() = default;
+
+    bool insert(const K& key, const V& value);
+    bool remove(const K& key);
+    V* find(const K& key);
+    const V* find(const K& key) const;
+
+    pair<K, V> min() const;
+    pair<K, V> max() const;
+    vector<pair<K, V>> findRange(const K& minKey, const K& maxKey) const;
+    size_t countRange(const K& minKey, const K& maxKey) const;
+    vector<pair<K, V>> selectRange(size_t first, size_t count) const;  // pairs ranked [first, first + count)
+
+    // Visits pairs with key >= startKey in order until visit returns false
+    void scanFrom(const K& startKey, const function<bool(const K&, const V&)>& visit) const;
+
+    size_t size() const { return nodeCount; }
+    bool empty() const { return nodeCount == 0; }
+    size_t getFanout() const { return maxKeys + 1; }
+    int getTreeHeight() const;
+
+    vector<pair<K, V>> inOrderTraversal() const;
+    void displayTree() const;
+
+    // For testing and debugging
+    bool isValidBPlusTree() const;
+
+protected:
+    void displayHelper(const BPlusNode* node, int depth) const;
+    bool isValidHelper(const BPlusNode* node, const K* minVal, const K* maxVal, int depth, int& leafDepth, bool isRoot) const;
+};
+
+#include "../solution/bplus_tree.cpp"
@@ -18,8 +18,9 @@ public:
         shared_ptr<BSTNode> right;
         weak_ptr<BSTNode> parent;
         int height;  // For AVL tree extension
+        size_t size; // Nodes in this subtree (order-statistic augmentation)
         
-        BSTNode(const K& k, const V& v) : key(k), value(v), left(nullptr), right(nullptr), height(1) {}
+        BSTNode(const K& k, const V& v) : key(k), value(v), left(nullptr), right(nullptr), height(1), size(1) {}
     };
 protected:    
     shared_ptr<BSTNode> root;
@@ -32,8 +33,9 @@ protected:
     shared_ptr<BSTNode> findHelper(shared_ptr<BSTNode> node, const K& key) const;
     shared_ptr<BSTNode> findMinHelper(shared_ptr<BSTNode> node) const;
     shared_ptr<BSTNode> findMaxHelper(shared_ptr<BSTNode> node) const;
-    void updateHeight(shared_ptr<BSTNode> node);  // For AVL extension
+    void updateHeight(shared_ptr<BSTNode> node);  // For AVL extension (also refreshes subtree size)
     int getHeight(shared_ptr<BSTNode> node) const;
+    size_t getSize(shared_ptr<BSTNode> node) const;
 
 public:
     BST();
@@ -50,6 +52,12 @@ public:
     pair<K, V> max() const;
     vector<pair<K, V>> findRange(const K& minKey, const K& maxKey) const;
     
+    // Order-statistic queries, O(log n) using subtree sizes
+    size_t rank(const K& key) const;                        // number of keys strictly less than key
+    pair<K, V> select(size_t k) const;                      // k-th smallest pair (0-based)
+    size_t countRange(const K& minKey, const K& maxKey) const;  // number of keys in [minKey, maxKey]
+    vector<pair<K, V>> selectRange(size_t first, size_t count) const;  // pairs ranked [first, first + count)
+    
     size_t size() const { return nodeCount; }
     bool empty() const { return nodeCount == 0; }
     int getTreeHeight() const { return getHeight(root); }
@@ -73,6 +81,8 @@ protected:
     void displayHelper(shared_ptr<BSTNode> node, int depth) const;
     bool isValidBSTHelper(shared_ptr<BSTNode> node, const K* minVal, const K* maxVal) const;
     void rangeHelper(shared_ptr<BSTNode> node, const K& minKey, const K& maxKey, vector<pair<K, V>>& result) const;
+    size_t countLessHelper(const K& key, bool inclusive) const;
+    void selectRangeHelper(shared_ptr<BSTNode> node, size_t first, size_t last, vector<pair<K, V>>& result) const;
 };
 
 #include "../solution/bst.cpp"
\ No newline at end of file
@@ -2,10 +2,48 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <string_view>
+#include <atomic>
+#include <unordered_map>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include "work_stealing_pool.h"
 using namespace std;
 
 struct Post; // Forward declaration
 
+/**
+ * Splits a category path on '_' into views of the original string, without
+ * allocating. Empty segments ("A__B", leading or trailing '_') are skipped.
+ */
+class CategoryPathTokenizer
+{
+public:
+    explicit CategoryPathTokenizer(string_view path) : rest(path) {}
+
+    // Sets segment to the next piece of the path; false once the path is exhausted
+    bool next(string_view &segment)
+    {
+        size_t start = rest.find_first_not_of('_');
+        if (start == string_view::npos)
+        {
+            rest = string_view();
+            return false;
+        }
+        size_t end = rest.find('_', start);
+        if (end == string_view::npos)
+            end = rest.size();
+        segment = rest.substr(start, end - start);
+        rest.remove_prefix(end);
+        return true;
+    }
+
+private:
+    string_view rest;
+};
+
 /**
  * Node in the category hierarchy tree
  */
@@ -15,18 +53,49 @@ public:
     string categoryName;
     vector<shared_ptr<CategoryNode>> children;
     weak_ptr<CategoryNode> parent;
-    vector<Post *> posts; // Posts directly in this category
-    int totalPostCount;   // Posts in this category + all subcategories
+    vector<Post *> posts;        // Posts directly in this category
+    atomic<int> totalPostCount;  // Posts in this category + all subcategories
+
+    // Concurrent-mode synchronisation, driven by CategoryTree (node methods do not lock)
+    mutable shared_mutex lock;       // guards children, childIndex; held exclusive by writers rewiring them
+    mutable shared_mutex parentLock; // guards parent; posters hold it shared on every ancestor below the root
+    mutable mutex postsLock;         // guards posts
+    atomic<int> writersWaiting;      // writers about to move or remove this node; posters back off instead of starving them
+
+    // Name -> child lookup, built once a node has more than CHILD_INDEX_THRESHOLD children
+    static const size_t CHILD_INDEX_THRESHOLD = 8;
+    unordered_map<string_view, CategoryNode *> childIndex; // keys view each child's own categoryName
+
+    // This subtree's slice [tourBegin, tourEnd) of the tree's Euler-tour post array
+    size_t tourBegin;
+    size_t tourEnd;
 
     CategoryNode(const string &name);
 
     // Students must implement these methods
     void addChild(shared_ptr<CategoryNode> child);
     bool removeChild(const string &childName);
-    shared_ptr<CategoryNode> findChild(const string &childName) const;
+    shared_ptr<CategoryNode> findChild(string_view childName) const;
     void addPost(Post *post);
     bool removePost(Post *post);
+    Post *removePostAt(size_t slot); // swap-and-pop; returns the post moved into slot, or nullptr
     void updatePostCounts(); // Recalculate totalPostCount recursively
+    void adjustPostCount(int delta); // Add delta to this node and every ancestor, O(depth)
+};
+
+/**
+ * Read-only view of a contiguous run of posts; valid until the tree is next modified
+ */
+struct PostSpan
+{
+    Post *const *first;
+    size_t count;
+
+    Post *const *begin() const { return first; }
+    Post *const *end() const { return first + count; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    Post *operator[](size_t i) const { return first[i]; }
 };
 
 /**
@@ -37,35 +106,73 @@ class CategoryTree
 protected:
     shared_ptr<CategoryNode> root;
 
+    // canonical full path -> node (root excluded), sharded by path so lookups rarely share a lock
+    static const size_t PATH_INDEX_SHARDS = 64;
+    struct alignas(64) PathIndexShard
+    {
+        shared_mutex lock;
+        unordered_map<string, shared_ptr<CategoryNode>> nodes;
+    };
+    mutable PathIndexShard pathIndex[PATH_INDEX_SHARDS];
+
+    // post -> (node, index in node->posts), sharded by post address so concurrent posters rarely share a lock
+    static const size_t POST_SLOT_SHARDS = 64;
+    struct alignas(64) PostSlotShard
+    {
+        mutex lock;
+        unordered_map<Post *, pair<CategoryNode *, size_t>> slots;
+    };
+    mutable PostSlotShard postSlots[POST_SLOT_SHARDS];
+
+    // Concurrent mode: a poster pins the parent links of its category's ancestors below the
+    // root, so posts never touch the root's locks and only wait for a move or removal of one
+    // of their own ancestors. Category adds, removes and moves lock the child lists they
+    // rewire and the parent link they change exclusively, and pin every ancestor of those
+    // nodes, so structural changes in unrelated subtrees also run side by side
+    const bool concurrent;
+    static const int MAX_STRUCTURE_RETRIES = 16; // re-resolutions after a concurrent move or removal
+
+    // Compacted layout: every post in one array ordered by a pre-order walk, so each
+    // subtree is one slice. Rebuilt lazily by getPostSpan() after any modification.
+    mutable vector<Post *> tourPosts;
+    mutable atomic<bool> layoutDirty;
+
+    mutable unique_ptr<WorkStealingPool> pool; // created on the first parallelReduce
+    mutable once_flag poolOnce;                // parallelReduce may be called from several threads at once
+
     // Helper method to parse category path (implemented for students)
     vector<string> parseCategoryPath(const string &path) const
     {
         vector<string> categories;
-        string current;
-        for (char c : path)
-        {
-            if (c == '_')
-            {
-                if (!current.empty())
-                {
-                    categories.push_back(current);
-                    current.clear();
-                }
-            }
-            else
-            {
-                current += c;
-            }
-        }
-        if (!current.empty())
+        CategoryPathTokenizer tokens(path);
+        for (string_view segment; tokens.next(segment);)
         {
-            categories.push_back(current);
+            categories.emplace_back(segment);
         }
         return categories;
     }
 
+    string canonicalPath(string_view path) const;                    // segments joined by single '_'
+    shared_ptr<CategoryNode> resolvePath(string_view path) const;    // walks segments down from the root
+    string pathOf(const shared_ptr<CategoryNode> &node) const;       // canonical path from parent links; "" for the root
+    shared_ptr<CategoryNode> childOf(const shared_ptr<CategoryNode> &node, string_view name) const;
+    shared_ptr<CategoryNode> parentOf(const shared_ptr<CategoryNode> &node) const;
+    PathIndexShard &indexShardFor(const string &path) const { return pathIndex[hash<string>()(path) % PATH_INDEX_SHARDS]; }
+    shared_ptr<CategoryNode> indexFind(const string &path) const;
+    void indexSubtree(const shared_ptr<CategoryNode> &node, const string &path, bool add);
+    void layoutSubtree(CategoryNode *node) const;
+    WorkStealingPool &workerPool() const;
+
+    PostSlotShard &shardFor(Post *post) const { return postSlots[hash<Post *>()(post) % POST_SLOT_SHARDS]; }
+    bool lockAncestry(const shared_ptr<CategoryNode> &node, vector<shared_ptr<CategoryNode>> &chain) const;
+    static void unlockAncestry(vector<shared_ptr<CategoryNode>> &chain);
+    void addPostConcurrent(Post *post);
+    bool removePostConcurrent(Post *post);
+
 public:
-    CategoryTree();
+    // concurrentMode enables thread-safe category and post operations. Iterators,
+    // getPostSpan, parallelReduce and displayTree stay unsynchronised in either mode.
+    explicit CategoryTree(bool concurrentMode = false);
 
     // Students must implement these methods
     bool addCategory(const string &categoryPath);
@@ -76,6 +183,9 @@ public:
     bool removePost(Post *post);
     vector<Post *> getPostsInCategory(const string &categoryPath, bool includeSubcategories = true) const;
 
+    // Zero-copy view of every post in the category and its subcategories (empty if not found)
+    PostSpan getPostSpan(const string &categoryPath) const;
+
     // Tree traversal methods - students must implement
     class PreOrderIterator;
     class PostOrderIterator;
@@ -88,6 +198,20 @@ public:
     BreadthFirstIterator breadthFirstBegin() const;
     BreadthFirstIterator breadthFirstEnd() const;
 
+    /**
+     * Folds mapFn(node) over every node of the subtree using all cores.
+     * Children whose totalPostCount reaches grainSize become separate tasks
+     * on a work-stealing pool; lighter subtrees are reduced inline by the
+     * task that reaches them. combineFn must be associative and commutative,
+     * since partial results are combined in no particular order. The tree
+     * must not be modified during the call, and mapFn must not start another
+     * parallelReduce: it runs on the pool, which cannot wait on itself. An
+     * exception from mapFn or combineFn is rethrown once all tasks have stopped.
+     */
+    template <typename R, typename MapFn, typename CombineFn>
+    R parallelReduce(shared_ptr<CategoryNode> subtreeRoot, R identity, MapFn mapFn, CombineFn combineFn,
+                     int grainSize = 1024) const;
+
     void displayTree() const;
     shared_ptr<CategoryNode> getRoot() const { return root; }
 };
@@ -153,4 +277,55 @@ public:
     bool operator==(const BreadthFirstIterator &other) const;
 };
 
+template <typename R, typename MapFn, typename CombineFn>
+R CategoryTree::parallelReduce(shared_ptr<CategoryNode> subtreeRoot, R identity, MapFn mapFn, CombineFn combineFn,
+                               int grainSize) const
+{
+    if (!subtreeRoot)
+        return identity;
+    WorkStealingPool &workers = workerPool();
+    mutex partialsMutex;
+    vector<R> partials;
+    exception_ptr failure;
+
+    function<void(CategoryNode *)> reduceSubtree = [&](CategoryNode *start)
+    {
+        try
+        {
+            R acc = identity;
+            vector<CategoryNode *> stack{start};
+            while (!stack.empty())
+            {
+                CategoryNode *node = stack.back();
+                stack.pop_back();
+                acc = combineFn(acc, mapFn(*node));
+                for (const auto &child : node->children)
+                {
+                    if (child->totalPostCount >= grainSize)
+                        workers.submit([&reduceSubtree, heavy = child.get()]() { reduceSubtree(heavy); });
+                    else
+                        stack.push_back(child.get());
+                }
+            }
+            lock_guard<mutex> lock(partialsMutex);
+            partials.push_back(move(acc));
+        }
+        catch (...)
+        {
+            lock_guard<mutex> lock(partialsMutex);
+            if (!failure)
+                failure = current_exception();
+        }
+    };
+
+    workers.submit([&]() { reduceSubtree(subtreeRoot.get()); });
+    workers.wait();
+    if (failure)
+        rethrow_exception(failure);
+    R result = identity;
+    for (R &partial : partials)
+        result = combineFn(result, partial);
+    return result;
+}
+
 // #include "../solution/category_tree.cpp"
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+using namespace std;
+
+/**
+ * Epoch-based reclamation for data published to concurrent readers
+ *
+ * A reader pins the current global epoch in a slot for the duration of a
+ * ReadGuard. That costs one slot claim and two stores, with no locks and no
+ * reference counting. A writer retires an object it has unpublished. The
+ * object is released only once every pinned reader entered a later epoch,
+ * so no reader can still be using it.
+ */
+class EpochReclaimer {
+public:
+    static const size_t MAX_READERS = 128;  // concurrent ReadGuards; extra readers wait for a slot
+
+    class ReadGuard {
+    public:
+        explicit ReadGuard(EpochReclaimer& reclaimer);
+        ~ReadGuard();
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+    private:
+        EpochReclaimer& owner;
+        size_t slot;
+    };
+
+    EpochReclaimer();
+    ~EpochReclaimer();
+
+    void retire(shared_ptr<const void> object);  // call after the object has been unpublished
+    size_t reclaim();                            // frees retired objects no reader can see; returns count freed
+    size_t pendingCount() const;
+
+private:
+    static const uint64_t IDLE = 0;
+
+    struct alignas(64) Slot {  // one cache line per reader slot to avoid false sharing
+        atomic<uint64_t> epoch;
+        atomic<bool> claimed;
+    };
+
+    atomic<uint64_t> globalEpoch;
+    Slot slots[MAX_READERS];
+
+    mutable mutex retiredMutex;  // writers only
+    vector<pair<uint64_t, shared_ptr<const void>>> retired;
+
+    uint64_t oldestPinnedEpoch() const;
+};
@@ -0,0 +1,27 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+using namespace std;
+
+/**
+ * Levenshtein distance against a fixed pattern
+ *
+ * For patterns of up to 64 characters this uses the bit-parallel algorithm
+ * of Myers (in Hyyro's formulation). It does O(|text|) word operations
+ * instead of filling an O(|pattern| * |text|) table. Longer patterns fall
+ * back to the two-row dynamic program.
+ */
+class LevenshteinMatcher {
+public:
+    explicit LevenshteinMatcher(const string& pattern);
+
+    int distance(const string& text) const;
+    const string& getPattern() const { return pattern; }
+
+    static int dynamicDistance(const string& a, const string& b);  // classic DP, any length
+
+private:
+    string pattern;
+    array<uint64_t, 256> peq;  // peq[c] has bit i set when pattern[i] == c
+};
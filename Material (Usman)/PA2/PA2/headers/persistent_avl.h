@@ -0,0 +1,68 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+using namespace std;
+
+/**
+ * Persistent (immutable) AVL tree
+ *
+ * Every update path-copies the O(log n) nodes from the root to the change
+ * and shares all other subtrees with the previous version. Old versions
+ * stay valid and unchanged, so a reader holding one never sees a writer's
+ * work in progress. Nodes carry height and subtree size, as BSTNode does.
+ */
+template<typename K, typename V>
+class PersistentAVL {
+public:
+    struct Node {
+        K key;
+        V value;
+        shared_ptr<const Node> left;
+        shared_ptr<const Node> right;
+        int height;
+        size_t size;
+
+        Node(const K& k, const V& v, shared_ptr<const Node> l, shared_ptr<const Node> r);
+    };
+    using NodePtr = shared_ptr<const Node>;
+
+private:
+    NodePtr root;
+
+    explicit PersistentAVL(NodePtr r) : root(move(r)) {}
+
+    static int heightOf(const Node* node) { return node ? node->height : 0; }
+    static size_t sizeOf(const Node* node) { return node ? node->size : 0; }
+    static NodePtr balance(const K& key, const V& value, const NodePtr& left, const NodePtr& right);
+    static NodePtr insertHelper(const NodePtr& node, const K& key, const V& value, bool& inserted);
+    static NodePtr assignHelper(const NodePtr& node, const K& key, const V& value);
+    static NodePtr removeHelper(const NodePtr& node, const K& key, bool& removed);
+    static NodePtr removeMin(const NodePtr& node, NodePtr& minNode);
+    static void rangeHelper(const Node* node, const K& minKey, const K& maxKey, vector<pair<K, V>>& result);
+    static void selectRangeHelper(const Node* node, size_t first, size_t last, vector<pair<K, V>>& result);
+    static bool isValidHelper(const Node* node, const K* minVal, const K* maxVal);
+
+public:
+    PersistentAVL() = default;
+
+    // Updates return the new version; *this is left untouched
+    PersistentAVL insert(const K& key, const V& value, bool* inserted = nullptr) const;
+    PersistentAVL remove(const K& key, bool* removed = nullptr) const;
+    PersistentAVL assign(const K& key, const V& value) const;  // insert, or replace the value of an existing key
+
+    const V* find(const K& key) const;
+    size_t size() const { return sizeOf(root.get()); }
+    bool empty() const { return !root; }
+    int getTreeHeight() const { return heightOf(root.get()); }
+
+    size_t rank(const K& key) const;        // number of keys strictly less than key
+    size_t countRange(const K& minKey, const K& maxKey) const;
+    vector<pair<K, V>> findRange(const K& minKey, const K& maxKey) const;
+    vector<pair<K, V>> selectRange(size_t first, size_t count) const;
+    vector<pair<K, V>> inOrderTraversal() const;
+
+    bool isValidAVL() const;
+};
+
+#include "../solution/persistent_avl.cpp"
@@ -0,0 +1,57 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+#include "levenshtein.h"
+using namespace std;
+
+/**
+ * Persistent (immutable) Burkhard-Keller tree
+ *
+ * The snapshot counterpart of BKTree, with the same search and the same
+ * lazy removal. An update path-copies the nodes from the root down to the
+ * changed node and shares every other subtree with the previous version, so
+ * a reader holding an old version never sees a writer's work in progress.
+ * Once dead entries outnumber live ones, the live entries are reinserted
+ * into a fresh tree.
+ */
+template<typename V>
+class PersistentBKTree {
+public:
+    struct Node {
+        string key;
+        V value;
+        bool alive;
+        vector<pair<int, shared_ptr<const Node>>> children;    // (distance to key, subtree)
+
+        Node(const string& k, const V& v) : key(k), value(v), alive(true) {}
+    };
+    using NodePtr = shared_ptr<const Node>;
+
+private:
+    NodePtr root;
+    size_t liveCount = 0;
+    size_t deadCount = 0;
+
+    // Path from the root to key: each ancestor with the index of the child taken. Returns
+    // the node holding key, or nullptr with *distance set to its distance from the last ancestor.
+    const Node* descend(const string& key, vector<pair<const Node*, size_t>>& path, int* distance) const;
+    static NodePtr copyPath(const vector<pair<const Node*, size_t>>& path, NodePtr replacement);
+    static void collectLive(const Node* node, vector<pair<string, V>>& entries);
+
+public:
+    // Updates return the new version; *this is left untouched
+    PersistentBKTree insert(const string& key, const V& value, bool* inserted = nullptr) const;
+    PersistentBKTree remove(const string& key, bool* removed = nullptr) const;
+    const V* find(const string& key) const;
+
+    // Appends (distance, value) for every key within maxDistance of query.
+    // If visited is given, it receives the number of nodes whose distance was computed.
+    void search(const string& query, int maxDistance, vector<pair<int, V>>& results,
+                size_t* visited = nullptr) const;
+
+    size_t size() const { return liveCount; }
+    bool empty() const { return liveCount == 0; }
+};
+
+#include "../solution/persistent_bk_tree.cpp"
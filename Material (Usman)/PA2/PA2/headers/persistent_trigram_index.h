@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "persistent_avl.h"
+#include "trigram_index.h"
+using namespace std;
+
+/**
+ * Persistent (immutable) trigram index
+ *
+ * The snapshot counterpart of TrigramIndex. An outer PersistentAVL maps each
+ * packed trigram to a PersistentAVL of the keys that contain it. An update
+ * path-copies one posting tree per trigram of the key, plus the outer path
+ * to it, and shares everything else with the previous version. Readers of an
+ * old version are unaffected. A substring query walks the shortest posting
+ * tree of its trigrams in key order and verifies each key with string::find,
+ * so matches come out sorted and a limit ends the walk early.
+ */
+template<typename V>
+class PersistentTrigramIndex {
+private:
+    using Postings = PersistentAVL<string, V>;
+
+    PersistentAVL<uint32_t, Postings> postings;    // packed trigram -> keys containing it
+    Postings keys;                                  // every key, for fragments shorter than a trigram
+
+public:
+    // Updates return the new version; *this is left untouched. Both ignore a no-op.
+    PersistentTrigramIndex insert(const string& key, const V& value) const;
+    PersistentTrigramIndex remove(const string& key) const;
+
+    // Appends (key, value) for every key containing fragment, in key order, stopping after
+    // limit matches (0 = all). If candidates is given, it receives the number of keys checked.
+    void search(const string& fragment, vector<pair<string, V>>& results, size_t limit = 0,
+                size_t* candidates = nullptr) const;
+
+    size_t size() const { return keys.size(); }
+    size_t trigramCount() const { return postings.size(); }
+};
+
+#include "../solution/persistent_trigram_index.cpp"
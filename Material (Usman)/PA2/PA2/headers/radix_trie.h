@@ -0,0 +1,52 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+using namespace std;
+
+/**
+ * Compressed radix trie keyed by strings
+ *
+ * Chains of single-child nodes are merged into one edge label. Children are
+ * sorted by the first byte of their label, so a pre-order walk yields keys in
+ * the same order as std::string comparison. A prefix query costs
+ * O(prefix length + nodes visited for the returned results).
+ */
+template<typename V>
+class RadixTrie {
+public:
+    struct RadixNode {
+        string label;                               // edge label from the parent
+        bool hasValue;
+        V value;
+        vector<unique_ptr<RadixNode>> children;     // sorted by label[0] as unsigned char
+
+        RadixNode(const string& l) : label(l), hasValue(false), value() {}
+    };
+
+private:
+    unique_ptr<RadixNode> root;
+    size_t keyCount;
+
+    size_t childSlot(const RadixNode* node, unsigned char first) const;
+    RadixNode* findChild(const RadixNode* node, unsigned char first) const;
+    bool removeHelper(RadixNode* node, const string& key, size_t pos);
+    void collectHelper(const RadixNode* node, size_t limit, vector<V>& results) const;
+
+public:
+    RadixTrie();
+
+    bool insert(const string& key, const V& value);     // false if key already present
+    bool remove(const string& key);
+    V* find(const string& key);
+    const V* find(const string& key) const;
+
+    // Appends values whose key starts with prefix, in sorted key order (limit 0 = no limit)
+    void collectPrefix(const string& prefix, size_t limit, vector<V>& results) const;
+
+    size_t size() const { return keyCount; }
+    bool empty() const { return keyCount == 0; }
+    void clear();
+};
+
+#include "../solution/radix_trie.cpp"
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+using namespace std;
+
+/**
+ * Inverted index from character trigrams to the keys that contain them
+ *
+ * Every key gets a small integer id. Each distinct trigram in the key maps to
+ * a posting list of ids, kept sorted. A substring query of length >= 3 looks
+ * up the posting lists of its own trigrams and intersects them, starting from
+ * the shortest. Only the surviving candidates are checked with string::find,
+ * so the cost tracks the rarest trigram of the query rather than the number
+ * of keys. Queries shorter than three characters have no trigram to look up
+ * and fall back to scanning every key.
+ *
+ * Ids are handed out in increasing order, so an insert only appends to each
+ * list. Removal just marks the entry dead and leaves its id in the lists,
+ * where searches skip it. Once dead entries outnumber live ones, compact()
+ * renumbers the live ids and filters every list in one pass, so both updates
+ * cost O(trigrams in the key) amortised, however common the trigrams are.
+ */
+template<typename V>
+class TrigramIndex {
+public:
+    struct Entry {
+        string key;
+        V value;
+        bool alive;
+    };
+
+private:
+    vector<Entry> entries;                              // indexed by id
+    size_t deadCount = 0;                               // removed entries whose ids are still listed
+    unordered_map<string, uint32_t> idOf;
+    unordered_map<uint32_t, vector<uint32_t>> postings; // packed trigram -> sorted ids
+
+    static uint32_t packTrigram(const string& text, size_t pos);
+    void compact();
+
+public:
+    static vector<uint32_t> trigramsOf(const string& text);   // distinct packed trigrams, sorted
+
+    bool insert(const string& key, const V& value);     // false if key already present
+    bool remove(const string& key);
+    const V* find(const string& key) const;
+
+    // Appends (key, value) for every key containing fragment, in no particular order.
+    // If candidates is given, it receives the number of keys checked with string::find.
+    void search(const string& fragment, vector<pair<string, V>>& results,
+                size_t* candidates = nullptr) const;
+
+    size_t size() const { return idOf.size(); }
+    bool empty() const { return idOf.empty(); }
+    size_t trigramCount() const { return postings.size(); }  // lists of only removed ids linger until compact()
+    void clear();
+};
+
+#include "../solution/trigram_index.cpp"
@@ -1,21 +1,58 @@
 #pragma once
 #include "avl_tree.h"
+#include "bplus_tree.h"
+#include "radix_trie.h"
+#include "bk_tree.h"
+#include "trigram_index.h"
+#include "persistent_avl.h"
+#include "persistent_bk_tree.h"
+#include "persistent_trigram_index.h"
+#include "epoch_reclaimer.h"
 #include "../headers/linked_list.h"
 #include "../headers/user.h"
+#include <atomic>
+#include <mutex>
 #include <string>
 #include <vector>
 using namespace std;
 
+// Ordered index structure backing the search engine
+enum IndexBackend
+{
+    AVL_INDEX,
+    BPLUS_TREE_INDEX,
+    SNAPSHOT_AVL_INDEX  // thread-safe: lock-free readers on immutable snapshots, one writer at a time
+};
+
 /**
- * High-performance user search engine using AVL trees
+ * High-performance user search engine using AVL trees (or B+ trees)
  */
 class UserSearchEngine {
 protected:
+    IndexBackend backend;
     AVLTree<int, User*> usersByID;           // Primary index: userID -> User*
     AVLTree<string, User*> usersByName; // Secondary index: username -> User*
+    BPlusTree<int, User*> bplusByID;         // Used instead of the AVL indices for BPLUS_TREE_INDEX
+    BPlusTree<string, User*> bplusByName;
+    RadixTrie<User*> usernameTrie;           // Prefix index over usernames (kept for every backend)
+    BKTree<User*> usernameBKTree;            // Metric index for fuzzy (edit-distance) lookups
+    TrigramIndex<User*> usernameTrigrams;    // Inverted index for substring ("contains") lookups
+
+    // SNAPSHOT_AVL_INDEX state: readers load the published version under an epoch guard,
+    // writers path-copy it under writerMutex and publish the result
+    struct UserSnapshot {
+        PersistentAVL<int, User*> byID;
+        PersistentAVL<string, User*> byName;
+        PersistentTrigramIndex<User*> nameTrigrams;
+        PersistentBKTree<User*> nameBKTree;
+    };
+    atomic<const UserSnapshot*> publishedSnapshot;
+    shared_ptr<const UserSnapshot> writerSnapshot;  // owns the published version
+    mutable EpochReclaimer reclaimer;
+    mutex writerMutex;
 
 public:
-    UserSearchEngine();
+    UserSearchEngine(IndexBackend indexBackend = AVL_INDEX);
     ~UserSearchEngine();
     
     // Migration from PA1 - students must implement
@@ -29,9 +66,14 @@ public:
     // Search operations - students must implement
     User* searchByID(int userID) const;
     User* searchByUsername(const string& username) const;
-    vector<User*> searchByUsernamePrefix(const string& prefix) const;
+    vector<User*> searchByUsernamePrefix(const string& prefix, size_t limit = 0) const;  // limit 0 = all matches
+    vector<User*> searchByUsernameSubstring(const string& fragment, size_t limit = 0) const;  // sorted by name
     vector<User*> getUsersInIDRange(int minID, int maxID) const;
     
+    // Order-statistic queries (O(log n) counts, O(log n + pageSize) pages)
+    size_t countUsersInIDRange(int minID, int maxID) const;
+    vector<User*> getUsersPage(size_t pageIndex, size_t pageSize, bool byID = true) const;
+    
     // Advanced search features - students must implement
     vector<User*> fuzzyUsernameSearch(const string& username, int maxEditDistance = 2) const;
     vector<User*> getAllUsersSorted(bool byID = true) const;
@@ -40,8 +82,12 @@ public:
     size_t getTotalUsers() const;
     void displaySearchStats() const;
     bool isConsistent() const;  // Verify both indices are in sync
+    IndexBackend getIndexBackend() const { return backend; }
     
 private:
+    void removeFromIndices(User* user);
+    void publishSnapshot(shared_ptr<const UserSnapshot> next);  // caller holds writerMutex
+
     // Helper methods for fuzzy search
     int calculateEditDistance(const string& str1, const string& str2) const;
     void collectPrefixMatches(const AVLTree<string, User*>& tree, const string& prefix, vector<User*>& results) const;
@@ -0,0 +1,59 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+/**
+ * Fixed-size thread pool with one task deque per worker
+ *
+ * A worker pushes the tasks it spawns onto the back of its own deque and
+ * pops from the back, so it keeps working on warm data. An idle worker
+ * steals from the front of another worker's deque, which takes the oldest
+ * and usually largest piece of work. Tasks submitted from outside the pool
+ * are spread round-robin across the deques.
+ */
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(size_t threads = 0);  // 0 = one worker per hardware thread
+    ~WorkStealingPool();
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    void submit(function<void()> task);  // tasks must not throw; may be called from inside a task
+
+    // Blocks until all tasks, spawned ones included, finish. Call it from outside the pool only:
+    // the task a worker is running counts as pending, so a worker waiting on its own pool deadlocks.
+    void wait();
+
+    size_t threadCount() const { return workers.size(); }
+    size_t stealCount() const { return steals.load(); }
+
+private:
+    struct alignas(64) WorkQueue {  // one cache line per queue head to avoid false sharing
+        mutex lock;
+        deque<function<void()>> tasks;
+    };
+
+    vector<unique_ptr<WorkQueue>> queues;
+    vector<thread> workers;
+
+    atomic<size_t> pending;    // submitted but not yet finished
+    atomic<size_t> queued;     // sitting in a deque
+    atomic<size_t> idle;       // workers asleep on workAvailable
+    atomic<size_t> nextQueue;  // round-robin target for external submits
+    atomic<size_t> steals;
+    atomic<bool> stopping;
+
+    mutex sleepMutex;
+    condition_variable workAvailable;
+    condition_variable allDone;
+
+    void workerLoop(size_t index);
+    bool runOne(size_t index);  // own deque first, then steal; false if every deque was empty
+};
@@ -13,66 +13,174 @@ AVLTree<K, V>::AVLTree(function<bool(const K&, const K&)> comp) : BST<K, V>(comp
 
 template<typename K, typename V>
 bool AVLTree<K, V>::insert(const K& key, const V& value) {
+    if (this->findHelper(this->root, key)) {
+        return false;
+    }
+    this->root = insertAVL(this->root, key, value);
+    this->root->parent.reset();
+    this->nodeCount++;
+    return true;
 }
 
 template<typename K, typename V>
 shared_ptr<typename AVLTree<K, V>::BSTNode> AVLTree<K, V>::insertAVL(shared_ptr<BSTNode> node, const K& key, const V& value) {
+    if (!node) {
+        return make_shared<BSTNode>(key, value);
+    }
+    if (this->comparator(key, node->key)) {
+        node->left = insertAVL(node->left, key, value);
+        node->left->parent = node;
+    } else if (this->comparator(node->key, key)) {
+        node->right = insertAVL(node->right, key, value);
+        node->right->parent = node;
+    } else {
+        return node;
+    }
+    return rebalance(node);
 }
 
 template<typename K, typename V>
 bool AVLTree<K, V>::remove(const K& key) {
+    if (!this->findHelper(this->root, key)) {
+        return false;
+    }
+    this->root = removeAVL(this->root, key);
+    if (this->root) {
+        this->root->parent.reset();
+    }
+    this->nodeCount--;
+    return true;
 }
 
 template<typename K, typename V>
 shared_ptr<typename AVLTree<K, V>::BSTNode> AVLTree<K, V>::removeAVL(shared_ptr<BSTNode> node, const K& key) {
+    if (!node) {
+        return nullptr;
+    }
+    if (this->comparator(key, node->key)) {
+        node->left = removeAVL(node->left, key);
+        if (node->left) node->left->parent = node;
+    } else if (this->comparator(node->key, key)) {
+        node->right = removeAVL(node->right, key);
+        if (node->right) node->right->parent = node;
+    } else {
+        if (!node->left || !node->right) {
+            shared_ptr<BSTNode> child = node->left ? node->left : node->right;
+            if (child) child->parent = node->parent;
+            return child;
+        }
+        shared_ptr<BSTNode> successor = this->findMinHelper(node->right);
+        node->key = successor->key;
+        node->value = successor->value;
+        node->right = removeAVL(node->right, successor->key);
+        if (node->right) node->right->parent = node;
+    }
+    return rebalance(node);
 }
 
 template<typename K, typename V>
 shared_ptr<typename AVLTree<K, V>::BSTNode> AVLTree<K, V>::rotateLeft(shared_ptr<BSTNode> node) {
+    shared_ptr<BSTNode> newRoot = node->right;
+    node->right = newRoot->left;
+    if (node->right) node->right->parent = node;
+    newRoot->left = node;
+    newRoot->parent = node->parent;
+    node->parent = newRoot;
+    this->updateHeight(node);
+    this->updateHeight(newRoot);
+    return newRoot;
 }
 
 template<typename K, typename V>
 shared_ptr<typename AVLTree<K, V>::BSTNode> AVLTree<K, V>::rotateRight(shared_ptr<BSTNode> node) {
+    shared_ptr<BSTNode> newRoot = node->left;
+    node->left = newRoot->right;
+    if (node->left) node->left->parent = node;
+    newRoot->right = node;
+    newRoot->parent = node->parent;
+    node->parent = newRoot;
+    this->updateHeight(node);
+    this->updateHeight(newRoot);
+    return newRoot;
 }
 
 template<typename K, typename V>
 shared_ptr<typename AVLTree<K, V>::BSTNode> AVLTree<K, V>::rotateLeftRight(shared_ptr<BSTNode> node) {
+    node->left = rotateLeft(node->left);
+    return rotateRight(node);
 }
 
 template<typename K, typename V>
 shared_ptr<typename AVLTree<K, V>::BSTNode> AVLTree<K, V>::rotateRightLeft(shared_ptr<BSTNode> node) {
+    node->right = rotateRight(node->right);
+    return rotateLeft(node);
 }
 
 template<typename K, typename V>
 int AVLTree<K, V>::getBalanceFactor(shared_ptr<BSTNode> node) const {
+    return node ? this->getHeight(node->left) - this->getHeight(node->right) : 0;
 }
 
 template<typename K, typename V>
 shared_ptr<typename AVLTree<K, V>::BSTNode> AVLTree<K, V>::rebalance(shared_ptr<BSTNode> node) {
+    this->updateHeight(node);
+    int balance = getBalanceFactor(node);
+    if (balance > 1) {
+        return getBalanceFactor(node->left) >= 0 ? rotateRight(node) : rotateLeftRight(node);
+    }
+    if (balance < -1) {
+        return getBalanceFactor(node->right) <= 0 ? rotateLeft(node) : rotateRightLeft(node);
+    }
+    return node;
 }
 
 template<typename K, typename V>
 bool AVLTree<K, V>::isBalanced() const {
+    return isValidAVLHelper(this->root);
 }
 
 template<typename K, typename V>
 bool AVLTree<K, V>::isValidAVLHelper(shared_ptr<BSTNode> node) const {
+    if (!node) {
+        return true;
+    }
+    int leftHeight = this->getHeight(node->left);
+    int rightHeight = this->getHeight(node->right);
+    if (abs(leftHeight - rightHeight) > 1 || node->height != 1 + max(leftHeight, rightHeight)) {
+        return false;
+    }
+    return isValidAVLHelper(node->left) && isValidAVLHelper(node->right);
 }
 
 template<typename K, typename V>
 int AVLTree<K, V>::getMaxDepth() const {
+    int totalDepth = 0, nodeCount = 0, maxDepth = 0;
+    calculateDepthStats(this->root, 1, totalDepth, nodeCount, maxDepth);
+    return maxDepth;
 }
 
 template<typename K, typename V>
 double AVLTree<K, V>::getAverageDepth() const {
+    int totalDepth = 0, nodeCount = 0, maxDepth = 0;
+    calculateDepthStats(this->root, 1, totalDepth, nodeCount, maxDepth);
+    return nodeCount ? static_cast<double>(totalDepth) / nodeCount : 0.0;
 }
 
 template<typename K, typename V>
 void AVLTree<K, V>::calculateDepthStats(shared_ptr<BSTNode> node, int depth, int& totalDepth, int& nodeCount, int& maxDepth) const {
+    if (!node) {
+        return;
+    }
+    totalDepth += depth;
+    nodeCount++;
+    maxDepth = max(maxDepth, depth);
+    calculateDepthStats(node->left, depth + 1, totalDepth, nodeCount, maxDepth);
+    calculateDepthStats(node->right, depth + 1, totalDepth, nodeCount, maxDepth);
 }
 
 template<typename K, typename V>
 bool AVLTree<K, V>::isValidAVL() const {
+    return this->isValidBST() && isBalanced();
 }
 
 template class AVLTree<int, string>;
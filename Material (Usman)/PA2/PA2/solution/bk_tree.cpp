@@ -0,0 +1,150 @@
+#include "../headers/bk_tree.h"
+#include <cstdlib>
+using namespace std;
+
+template<typename V>
+BKTree<V>::BKTree() : root(nullptr), liveCount(0), deadCount(0) {
+}
+
+template<typename V>
+typename BKTree<V>::BKNode* BKTree<V>::findNode(const string& key) const {
+    LevenshteinMatcher matcher(key);
+    BKNode* node = root.get();
+    while (node) {
+        int d = matcher.distance(node->key);
+        if (d == 0) {
+            return node;
+        }
+        BKNode* next = nullptr;
+        for (auto& child : node->children) {
+            if (child.first == d) {
+                next = child.second.get();
+                break;
+            }
+        }
+        node = next;
+    }
+    return nullptr;
+}
+
+template<typename V>
+bool BKTree<V>::insert(const string& key, const V& value) {
+    if (!root) {
+        root.reset(new BKNode(key, value));
+        liveCount++;
+        return true;
+    }
+    LevenshteinMatcher matcher(key);
+    BKNode* node = root.get();
+    while (true) {
+        int d = matcher.distance(node->key);
+        if (d == 0) {
+            if (node->alive) {
+                return false;
+            }
+            // Revive a previously removed entry in place
+            node->alive = true;
+            node->value = value;
+            deadCount--;
+            liveCount++;
+            return true;
+        }
+        BKNode* next = nullptr;
+        for (auto& child : node->children) {
+            if (child.first == d) {
+                next = child.second.get();
+                break;
+            }
+        }
+        if (!next) {
+            node->children.emplace_back(d, unique_ptr<BKNode>(new BKNode(key, value)));
+            liveCount++;
+            return true;
+        }
+        node = next;
+    }
+}
+
+template<typename V>
+bool BKTree<V>::remove(const string& key) {
+    BKNode* node = findNode(key);
+    if (!node || !node->alive) {
+        return false;
+    }
+    node->alive = false;
+    node->value = V();
+    liveCount--;
+    deadCount++;
+    if (deadCount > liveCount) {
+        rebuild();
+    }
+    return true;
+}
+
+template<typename V>
+const V* BKTree<V>::find(const string& key) const {
+    BKNode* node = findNode(key);
+    return node && node->alive ? &node->value : nullptr;
+}
+
+template<typename V>
+void BKTree<V>::search(const string& query, int maxDistance, vector<pair<int, V>>& results,
+                       size_t* visited) const {
+    if (visited) {
+        *visited = 0;
+    }
+    if (!root) {
+        return;
+    }
+    LevenshteinMatcher matcher(query);
+    vector<const BKNode*> stack = {root.get()};
+    while (!stack.empty()) {
+        const BKNode* node = stack.back();
+        stack.pop_back();
+        int d = matcher.distance(node->key);
+        if (visited) {
+            (*visited)++;
+        }
+        if (d <= maxDistance && node->alive) {
+            results.push_back({d, node->value});
+        }
+        for (const auto& child : node->children) {
+            if (abs(child.first - d) <= maxDistance) {
+                stack.push_back(child.second.get());
+            }
+        }
+    }
+}
+
+template<typename V>
+void BKTree<V>::collectLive(unique_ptr<BKNode>& node, vector<pair<string, V>>& entries) {
+    if (!node) {
+        return;
+    }
+    if (node->alive) {
+        entries.push_back({move(node->key), node->value});
+    }
+    for (auto& child : node->children) {
+        collectLive(child.second, entries);
+    }
+}
+
+template<typename V>
+void BKTree<V>::rebuild() {
+    vector<pair<string, V>> entries;
+    entries.reserve(liveCount);
+    collectLive(root, entries);
+    clear();
+    for (const auto& entry : entries) {
+        insert(entry.first, entry.second);
+    }
+}
+
+template<typename V>
+void BKTree<V>::clear() {
+    root.reset();
+    liveCount = 0;
+    deadCount = 0;
+}
+
+template class BKTree<int>;
@@ -0,0 +1,475 @@
+#include "../headers/bplus_tree.h"
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+using namespace std;
+
+template<typename K, typename V>
+BPlusTree<K, V>::BPlusTree(size_t fanout)
+    : BPlusTree([](const K& a, const K& b) { return a < b; }, fanout) {
+}
+
+template<typename K, typename V>
+BPlusTree<K, V>::BPlusTree(function<bool(const K&, const K&)> comp, size_t fanout)
+    : root(new BPlusNode(true)), nodeCount(0), comparator(comp) {
+    maxKeys = (fanout < 4 ? 4 : fanout) - 1;
+    minKeys = maxKeys / 2;
+    root->keys.reserve(maxKeys + 1);
+    root->values.reserve(maxKeys + 1);
+}
+
+template<typename K, typename V>
+size_t BPlusTree<K, V>::childIndex(const BPlusNode* node, const K& key) const {
+    // Keys equal to a separator live in the right subtree
+    return upper_bound(node->keys.begin(), node->keys.end(), key, comparator) - node->keys.begin();
+}
+
+template<typename K, typename V>
+size_t BPlusTree<K, V>::leafIndex(const BPlusNode* leaf, const K& key) const {
+    return lower_bound(leaf->keys.begin(), leaf->keys.end(), key, comparator) - leaf->keys.begin();
+}
+
+template<typename K, typename V>
+const typename BPlusTree<K, V>::BPlusNode* BPlusTree<K, V>::findLeaf(const K& key) const {
+    const BPlusNode* node = root.get();
+    while (!node->isLeaf) {
+        node = node->children[childIndex(node, key)].get();
+    }
+    return node;
+}
+
+template<typename K, typename V>
+const typename BPlusTree<K, V>::BPlusNode* BPlusTree<K, V>::leftmostLeaf() const {
+    const BPlusNode* node = root.get();
+    while (!node->isLeaf) {
+        node = node->children.front().get();
+    }
+    return node;
+}
+
+template<typename K, typename V>
+size_t BPlusTree<K, V>::subtreeSize(const BPlusNode* node) {
+    if (node->isLeaf) {
+        return node->keys.size();
+    }
+    size_t total = 0;
+    for (size_t count : node->counts) {
+        total += count;
+    }
+    return total;
+}
+
+template<typename K, typename V>
+size_t BPlusTree<K, V>::rankOf(const K& key, bool inclusive) const {
+    size_t rank = 0;
+    const BPlusNode* node = root.get();
+    while (!node->isLeaf) {
+        // Every child left of the descent holds only keys below a separator <= key
+        size_t index = childIndex(node, key);
+        for (size_t i = 0; i < index; ++i) {
+            rank += node->counts[i];
+        }
+        node = node->children[index].get();
+    }
+    if (inclusive) {
+        return rank + (upper_bound(node->keys.begin(), node->keys.end(), key, comparator) - node->keys.begin());
+    }
+    return rank + leafIndex(node, key);
+}
+
+template<typename K, typename V>
+bool BPlusTree<K, V>::insert(const K& key, const V& value) {
+    K separator = key;
+    bool inserted = false;
+    unique_ptr<BPlusNode> sibling = insertHelper(root.get(), key, value, separator, inserted);
+    if (sibling) {
+        unique_ptr<BPlusNode> newRoot(new BPlusNode(false));
+        newRoot->keys.reserve(maxKeys + 1);
+        newRoot->children.reserve(maxKeys + 2);
+        newRoot->counts.reserve(maxKeys + 2);
+        newRoot->keys.push_back(separator);
+        newRoot->counts.push_back(subtreeSize(root.get()));
+        newRoot->counts.push_back(subtreeSize(sibling.get()));
+        newRoot->children.push_back(move(root));
+        newRoot->children.push_back(move(sibling));
+        root = move(newRoot);
+    }
+    if (inserted) {
+        nodeCount++;
+    }
+    return inserted;
+}
+
+template<typename K, typename V>
+unique_ptr<typename BPlusTree<K, V>::BPlusNode> BPlusTree<K, V>::insertHelper(BPlusNode* node, const K& key, const V& value, K& separator, bool& inserted) {
+    if (node->isLeaf) {
+        size_t pos = leafIndex(node, key);
+        if (pos < node->keys.size() && !comparator(key, node->keys[pos])) {
+            return nullptr;  // duplicates are ignored
+        }
+        node->keys.insert(node->keys.begin() + pos, key);
+        node->values.insert(node->values.begin() + pos, value);
+        inserted = true;
+        if (node->keys.size() <= maxKeys) {
+            return nullptr;
+        }
+        size_t mid = node->keys.size() / 2;
+        unique_ptr<BPlusNode> right(new BPlusNode(true));
+        right->keys.reserve(maxKeys + 1);
+        right->values.reserve(maxKeys + 1);
+        right->keys.assign(make_move_iterator(node->keys.begin() + mid), make_move_iterator(node->keys.end()));
+        right->values.assign(make_move_iterator(node->values.begin() + mid), make_move_iterator(node->values.end()));
+        node->keys.erase(node->keys.begin() + mid, node->keys.end());
+        node->values.erase(node->values.begin() + mid, node->values.end());
+        right->next = node->next;
+        node->next = right.get();
+        separator = right->keys.front();
+        return right;
+    }
+
+    size_t index = childIndex(node, key);
+    K childSeparator = key;
+    unique_ptr<BPlusNode> sibling = insertHelper(node->children[index].get(), key, value, childSeparator, inserted);
+    if (inserted) {
+        node->counts[index]++;
+    }
+    if (!sibling) {
+        return nullptr;
+    }
+    size_t siblingCount = subtreeSize(sibling.get());
+    node->counts[index] -= siblingCount;
+    node->counts.insert(node->counts.begin() + index + 1, siblingCount);
+    node->keys.insert(node->keys.begin() + index, childSeparator);
+    node->children.insert(node->children.begin() + index + 1, move(sibling));
+    if (node->keys.size() <= maxKeys) {
+        return nullptr;
+    }
+    // The middle key moves up; it is not kept in either half
+    size_t mid = node->keys.size() / 2;
+    unique_ptr<BPlusNode> right(new BPlusNode(false));
+    right->keys.reserve(maxKeys + 1);
+    right->children.reserve(maxKeys + 2);
+    right->counts.reserve(maxKeys + 2);
+    separator = node->keys[mid];
+    right->keys.assign(make_move_iterator(node->keys.begin() + mid + 1), make_move_iterator(node->keys.end()));
+    right->children.assign(make_move_iterator(node->children.begin() + mid + 1), make_move_iterator(node->children.end()));
+    right->counts.assign(node->counts.begin() + mid + 1, node->counts.end());
+    node->keys.erase(node->keys.begin() + mid, node->keys.end());
+    node->children.erase(node->children.begin() + mid + 1, node->children.end());
+    node->counts.erase(node->counts.begin() + mid + 1, node->counts.end());
+    return right;
+}
+
+template<typename K, typename V>
+bool BPlusTree<K, V>::remove(const K& key) {
+    if (!removeHelper(root.get(), key)) {
+        return false;
+    }
+    nodeCount--;
+    if (!root->isLeaf && root->keys.empty()) {
+        root = move(root->children.front());
+    }
+    return true;
+}
+
+template<typename K, typename V>
+bool BPlusTree<K, V>::removeHelper(BPlusNode* node, const K& key) {
+    if (node->isLeaf) {
+        size_t pos = leafIndex(node, key);
+        if (pos == node->keys.size() || comparator(key, node->keys[pos])) {
+            return false;
+        }
+        node->keys.erase(node->keys.begin() + pos);
+        node->values.erase(node->values.begin() + pos);
+        return true;
+    }
+    size_t index = childIndex(node, key);
+    if (!removeHelper(node->children[index].get(), key)) {
+        return false;
+    }
+    node->counts[index]--;
+    if (node->children[index]->keys.size() < minKeys) {
+        fixUnderflow(node, index);
+    }
+    return true;
+}
+
+template<typename K, typename V>
+void BPlusTree<K, V>::fixUnderflow(BPlusNode* parent, size_t index) {
+    BPlusNode* child = parent->children[index].get();
+    BPlusNode* left = index > 0 ? parent->children[index - 1].get() : nullptr;
+    BPlusNode* right = index + 1 < parent->children.size() ? parent->children[index + 1].get() : nullptr;
+
+    if (left && left->keys.size() > minKeys) {
+        // Borrow the largest entry of the left sibling
+        if (child->isLeaf) {
+            child->keys.insert(child->keys.begin(), move(left->keys.back()));
+            child->values.insert(child->values.begin(), move(left->values.back()));
+            left->keys.pop_back();
+            left->values.pop_back();
+            parent->keys[index - 1] = child->keys.front();
+            parent->counts[index - 1]--;
+            parent->counts[index]++;
+        } else {
+            size_t moved = left->counts.back();
+            child->keys.insert(child->keys.begin(), move(parent->keys[index - 1]));
+            child->children.insert(child->children.begin(), move(left->children.back()));
+            child->counts.insert(child->counts.begin(), moved);
+            parent->keys[index - 1] = move(left->keys.back());
+            left->keys.pop_back();
+            left->children.pop_back();
+            left->counts.pop_back();
+            parent->counts[index - 1] -= moved;
+            parent->counts[index] += moved;
+        }
+        return;
+    }
+    if (right && right->keys.size() > minKeys) {
+        // Borrow the smallest entry of the right sibling
+        if (child->isLeaf) {
+            child->keys.push_back(move(right->keys.front()));
+            child->values.push_back(move(right->values.front()));
+            right->keys.erase(right->keys.begin());
+            right->values.erase(right->values.begin());
+            parent->keys[index] = right->keys.front();
+            parent->counts[index + 1]--;
+            parent->counts[index]++;
+        } else {
+            size_t moved = right->counts.front();
+            child->keys.push_back(move(parent->keys[index]));
+            child->children.push_back(move(right->children.front()));
+            child->counts.push_back(moved);
+            parent->keys[index] = move(right->keys.front());
+            right->keys.erase(right->keys.begin());
+            right->children.erase(right->children.begin());
+            right->counts.erase(right->counts.begin());
+            parent->counts[index + 1] -= moved;
+            parent->counts[index] += moved;
+        }
+        return;
+    }
+
+    // Neither sibling can lend: merge the right node of the pair into the left one
+    size_t leftIndex = left ? index - 1 : index;
+    BPlusNode* into = parent->children[leftIndex].get();
+    BPlusNode* from = parent->children[leftIndex + 1].get();
+    if (into->isLeaf) {
+        move(from->keys.begin(), from->keys.end(), back_inserter(into->keys));
+        move(from->values.begin(), from->values.end(), back_inserter(into->values));
+        into->next = from->next;
+    } else {
+        into->keys.push_back(move(parent->keys[leftIndex]));
+        move(from->keys.begin(), from->keys.end(), back_inserter(into->keys));
+        move(from->children.begin(), from->children.end(), back_inserter(into->children));
+        into->counts.insert(into->counts.end(), from->counts.begin(), from->counts.end());
+    }
+    parent->counts[leftIndex] += parent->counts[leftIndex + 1];
+    parent->keys.erase(parent->keys.begin() + leftIndex);
+    parent->children.erase(parent->children.begin() + leftIndex + 1);
+    parent->counts.erase(parent->counts.begin() + leftIndex + 1);
+}
+
+template<typename K, typename V>
+V* BPlusTree<K, V>::find(const K& key) {
+    return const_cast<V*>(static_cast<const BPlusTree*>(this)->find(key));
+}
+
+template<typename K, typename V>
+const V* BPlusTree<K, V>::find(const K& key) const {
+    const BPlusNode* leaf = findLeaf(key);
+    size_t pos = leafIndex(leaf, key);
+    if (pos == leaf->keys.size() || comparator(key, leaf->keys[pos])) {
+        return nullptr;
+    }
+    return &leaf->values[pos];
+}
+
+template<typename K, typename V>
+pair<K, V> BPlusTree<K, V>::min() const {
+    if (empty()) {
+        throw runtime_error("min() called on an empty tree");
+    }
+    const BPlusNode* leaf = leftmostLeaf();
+    return {leaf->keys.front(), leaf->values.front()};
+}
+
+template<typename K, typename V>
+pair<K, V> BPlusTree<K, V>::max() const {
+    if (empty()) {
+        throw runtime_error("max() called on an empty tree");
+    }
+    const BPlusNode* node = root.get();
+    while (!node->isLeaf) {
+        node = node->children.back().get();
+    }
+    return {node->keys.back(), node->values.back()};
+}
+
+template<typename K, typename V>
+void BPlusTree<K, V>::scanFrom(const K& startKey, const function<bool(const K&, const V&)>& visit) const {
+    const BPlusNode* leaf = findLeaf(startKey);
+    size_t pos = leafIndex(leaf, startKey);
+    for (; leaf; leaf = leaf->next, pos = 0) {
+        for (; pos < leaf->keys.size(); ++pos) {
+            if (!visit(leaf->keys[pos], leaf->values[pos])) {
+                return;
+            }
+        }
+    }
+}
+
+template<typename K, typename V>
+vector<pair<K, V>> BPlusTree<K, V>::findRange(const K& minKey, const K& maxKey) const {
+    vector<pair<K, V>> result;
+    if (comparator(maxKey, minKey)) {
+        return result;
+    }
+    scanFrom(minKey, [&](const K& key, const V& value) {
+        if (comparator(maxKey, key)) {
+            return false;
+        }
+        result.push_back({key, value});
+        return true;
+    });
+    return result;
+}
+
+template<typename K, typename V>
+size_t BPlusTree<K, V>::countRange(const K& minKey, const K& maxKey) const {
+    if (comparator(maxKey, minKey)) {
+        return 0;
+    }
+    return rankOf(maxKey, true) - rankOf(minKey, false);
+}
+
+template<typename K, typename V>
+vector<pair<K, V>> BPlusTree<K, V>::selectRange(size_t first, size_t count) const {
+    vector<pair<K, V>> result;
+    if (first >= nodeCount || count == 0) {
+        return result;
+    }
+    result.reserve(std::min(count, nodeCount - first));
+    // Descend by rank to the leaf holding pair number first, then follow the leaf chain
+    const BPlusNode* leaf = root.get();
+    while (!leaf->isLeaf) {
+        size_t i = 0;
+        while (first >= leaf->counts[i]) {
+            first -= leaf->counts[i++];
+        }
+        leaf = leaf->children[i].get();
+    }
+    for (size_t pos = first; leaf && result.size() < count; leaf = leaf->next, pos = 0) {
+        for (; pos < leaf->keys.size() && result.size() < count; ++pos) {
+            result.push_back({leaf->keys[pos], leaf->values[pos]});
+        }
+    }
+    return result;
+}
+
+template<typename K, typename V>
+int BPlusTree<K, V>::getTreeHeight() const {
+    if (empty()) {
+        return 0;
+    }
+    int height = 1;
+    for (const BPlusNode* node = root.get(); !node->isLeaf; node = node->children.front().get()) {
+        height++;
+    }
+    return height;
+}
+
+template<typename K, typename V>
+vector<pair<K, V>> BPlusTree<K, V>::inOrderTraversal() const {
+    vector<pair<K, V>> result;
+    result.reserve(nodeCount);
+    for (const BPlusNode* leaf = leftmostLeaf(); leaf; leaf = leaf->next) {
+        for (size_t i = 0; i < leaf->keys.size(); ++i) {
+            result.push_back({leaf->keys[i], leaf->values[i]});
+        }
+    }
+    return result;
+}
+
+template<typename K, typename V>
+void BPlusTree<K, V>::displayTree() const {
+    if (empty()) {
+        cout << "(empty tree)" << endl;
+        return;
+    }
+    displayHelper(root.get(), 0);
+}
+
+template<typename K, typename V>
+void BPlusTree<K, V>::displayHelper(const BPlusNode* node, int depth) const {
+    cout << string(depth * 4, ' ') << (node->isLeaf ? "leaf [" : "node [");
+    for (size_t i = 0; i < node->keys.size(); ++i) {
+        cout << (i ? " " : "") << node->keys[i];
+    }
+    cout << "]" << endl;
+    for (const auto& child : node->children) {
+        displayHelper(child.get(), depth + 1);
+    }
+}
+
+template<typename K, typename V>
+bool BPlusTree<K, V>::isValidBPlusTree() const {
+    int leafDepth = -1;
+    if (!isValidHelper(root.get(), nullptr, nullptr, 0, leafDepth, true)) {
+        return false;
+    }
+    // The leaf chain must visit every key exactly once, in order
+    size_t seen = 0;
+    const K* previous = nullptr;
+    for (const BPlusNode* leaf = leftmostLeaf(); leaf; leaf = leaf->next) {
+        for (const K& key : leaf->keys) {
+            if (previous && !comparator(*previous, key)) {
+                return false;
+            }
+            previous = &key;
+            seen++;
+        }
+    }
+    return seen == nodeCount;
+}
+
+template<typename K, typename V>
+bool BPlusTree<K, V>::isValidHelper(const BPlusNode* node, const K* minVal, const K* maxVal, int depth, int& leafDepth, bool isRoot) const {
+    if (node->keys.size() > maxKeys || (!isRoot && node->keys.size() < minKeys)) {
+        return false;
+    }
+    for (size_t i = 0; i < node->keys.size(); ++i) {
+        if (i > 0 && !comparator(node->keys[i - 1], node->keys[i])) {
+            return false;
+        }
+        if ((minVal && comparator(node->keys[i], *minVal)) || (maxVal && !comparator(node->keys[i], *maxVal))) {
+            return false;
+        }
+    }
+    if (node->isLeaf) {
+        if (node->values.size() != node->keys.size()) {
+            return false;
+        }
+        if (leafDepth < 0) {
+            leafDepth = depth;
+        }
+        return leafDepth == depth;
+    }
+    if (node->children.size() != node->keys.size() + 1 || node->counts.size() != node->children.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < node->children.size(); ++i) {
+        if (node->counts[i] != subtreeSize(node->children[i].get())) {
+            return false;
+        }
+        const K* low = i > 0 ? &node->keys[i - 1] : minVal;
+        const K* high = i < node->keys.size() ? &node->keys[i] : maxVal;
+        if (!isValidHelper(node->children[i].get(), low, high, depth + 1, leafDepth, false)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template class BPlusTree<int, string>;
+template class BPlusTree<string, string>;
+template class BPlusTree<int, int>;
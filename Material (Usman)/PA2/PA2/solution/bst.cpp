@@ -1,6 +1,7 @@
 #include "../headers/bst.h"
 #include <iostream>
 #include <algorithm>
+#include <stdexcept>
 using namespace std;
 
 template<typename K, typename V>
@@ -9,92 +10,324 @@ BST<K, V>::BST() : root(nullptr), nodeCount(0) {
 }
 
 template<typename K, typename V>
-BST<K, V>::BST(function<bool(const K&, const K&)> comp) 
+BST<K, V>::BST(function<bool(const K&, const K&)> comp)
     : root(nullptr), nodeCount(0), comparator(comp) {
 }
 
 template<typename K, typename V>
 bool BST<K, V>::insert(const K& key, const V& value) {
+    if (findHelper(root, key)) {
+        return false;  // duplicates are ignored
+    }
+    root = insertHelper(root, key, value);
+    root->parent.reset();
+    nodeCount++;
+    return true;
 }
 
 template<typename K, typename V>
 shared_ptr<typename BST<K, V>::BSTNode> BST<K, V>::insertHelper(shared_ptr<BSTNode> node, const K& key, const V& value) {
+    if (!node) {
+        return make_shared<BSTNode>(key, value);
+    }
+    if (comparator(key, node->key)) {
+        node->left = insertHelper(node->left, key, value);
+        node->left->parent = node;
+    } else if (comparator(node->key, key)) {
+        node->right = insertHelper(node->right, key, value);
+        node->right->parent = node;
+    }
+    updateHeight(node);
+    return node;
 }
 
 template<typename K, typename V>
 bool BST<K, V>::remove(const K& key) {
+    if (!findHelper(root, key)) {
+        return false;
+    }
+    root = removeHelper(root, key);
+    if (root) {
+        root->parent.reset();
+    }
+    nodeCount--;
+    return true;
 }
 
 template<typename K, typename V>
 shared_ptr<typename BST<K, V>::BSTNode> BST<K, V>::removeHelper(shared_ptr<BSTNode> node, const K& key) {
+    if (!node) {
+        return nullptr;
+    }
+    if (comparator(key, node->key)) {
+        node->left = removeHelper(node->left, key);
+        if (node->left) node->left->parent = node;
+    } else if (comparator(node->key, key)) {
+        node->right = removeHelper(node->right, key);
+        if (node->right) node->right->parent = node;
+    } else {
+        if (!node->left || !node->right) {
+            shared_ptr<BSTNode> child = node->left ? node->left : node->right;
+            if (child) child->parent = node->parent;
+            return child;
+        }
+        // Two children: take over the in-order successor, then delete it from the right subtree
+        shared_ptr<BSTNode> successor = findMinHelper(node->right);
+        node->key = successor->key;
+        node->value = successor->value;
+        node->right = removeHelper(node->right, successor->key);
+        if (node->right) node->right->parent = node;
+    }
+    updateHeight(node);
+    return node;
 }
 
 template<typename K, typename V>
 V* BST<K, V>::find(const K& key) {
+    shared_ptr<BSTNode> node = findHelper(root, key);
+    return node ? &node->value : nullptr;
 }
 
 template<typename K, typename V>
 const V* BST<K, V>::find(const K& key) const {
+    shared_ptr<BSTNode> node = findHelper(root, key);
+    return node ? &node->value : nullptr;
 }
 
 template<typename K, typename V>
 shared_ptr<typename BST<K, V>::BSTNode> BST<K, V>::findHelper(shared_ptr<BSTNode> node, const K& key) const {
+    while (node) {
+        if (comparator(key, node->key)) {
+            node = node->left;
+        } else if (comparator(node->key, key)) {
+            node = node->right;
+        } else {
+            return node;
+        }
+    }
+    return nullptr;
 }
 
 template<typename K, typename V>
 pair<K, V> BST<K, V>::min() const {
+    if (!root) {
+        throw runtime_error("min() called on an empty tree");
+    }
+    shared_ptr<BSTNode> node = findMinHelper(root);
+    return {node->key, node->value};
 }
 
 template<typename K, typename V>
 shared_ptr<typename BST<K, V>::BSTNode> BST<K, V>::findMinHelper(shared_ptr<BSTNode> node) const {
+    while (node && node->left) {
+        node = node->left;
+    }
+    return node;
 }
 
 template<typename K, typename V>
 pair<K, V> BST<K, V>::max() const {
+    if (!root) {
+        throw runtime_error("max() called on an empty tree");
+    }
+    shared_ptr<BSTNode> node = findMaxHelper(root);
+    return {node->key, node->value};
 }
 
 template<typename K, typename V>
 shared_ptr<typename BST<K, V>::BSTNode> BST<K, V>::findMaxHelper(shared_ptr<BSTNode> node) const {
+    while (node && node->right) {
+        node = node->right;
+    }
+    return node;
 }
 
 template<typename K, typename V>
 vector<pair<K, V>> BST<K, V>::findRange(const K& minKey, const K& maxKey) const {
+    vector<pair<K, V>> result;
+    if (comparator(maxKey, minKey)) {
+        return result;
+    }
+    rangeHelper(root, minKey, maxKey, result);
+    return result;
 }
 
 template<typename K, typename V>
 void BST<K, V>::rangeHelper(shared_ptr<BSTNode> node, const K& minKey, const K& maxKey, vector<pair<K, V>>& result) const {
+    if (!node) {
+        return;
+    }
+    bool aboveMin = !comparator(node->key, minKey);
+    bool belowMax = !comparator(maxKey, node->key);
+    if (aboveMin) {
+        rangeHelper(node->left, minKey, maxKey, result);
+    }
+    if (aboveMin && belowMax) {
+        result.push_back({node->key, node->value});
+    }
+    if (belowMax) {
+        rangeHelper(node->right, minKey, maxKey, result);
+    }
+}
+
+template<typename K, typename V>
+size_t BST<K, V>::rank(const K& key) const {
+    return countLessHelper(key, false);
+}
+
+template<typename K, typename V>
+pair<K, V> BST<K, V>::select(size_t k) const {
+    if (k >= getSize(root)) {
+        throw out_of_range("select() rank is out of range");
+    }
+    shared_ptr<BSTNode> node = root;
+    while (node) {
+        size_t leftSize = getSize(node->left);
+        if (k < leftSize) {
+            node = node->left;
+        } else if (k == leftSize) {
+            break;
+        } else {
+            k -= leftSize + 1;
+            node = node->right;
+        }
+    }
+    return {node->key, node->value};
+}
+
+template<typename K, typename V>
+size_t BST<K, V>::countRange(const K& minKey, const K& maxKey) const {
+    if (comparator(maxKey, minKey)) {
+        return 0;
+    }
+    return countLessHelper(maxKey, true) - countLessHelper(minKey, false);
+}
+
+template<typename K, typename V>
+vector<pair<K, V>> BST<K, V>::selectRange(size_t first, size_t count) const {
+    vector<pair<K, V>> result;
+    size_t total = getSize(root);
+    if (first >= total || count == 0) {
+        return result;
+    }
+    size_t last = first + std::min(count, total - first);
+    result.reserve(last - first);
+    selectRangeHelper(root, first, last, result);
+    return result;
+}
+
+template<typename K, typename V>
+size_t BST<K, V>::countLessHelper(const K& key, bool inclusive) const {
+    size_t count = 0;
+    shared_ptr<BSTNode> node = root;
+    while (node) {
+        bool goRight = inclusive ? !comparator(key, node->key) : comparator(node->key, key);
+        if (goRight) {
+            count += getSize(node->left) + 1;
+            node = node->right;
+        } else {
+            node = node->left;
+        }
+    }
+    return count;
+}
+
+template<typename K, typename V>
+void BST<K, V>::selectRangeHelper(shared_ptr<BSTNode> node, size_t first, size_t last, vector<pair<K, V>>& result) const {
+    if (!node || first >= last) {
+        return;
+    }
+    // first/last are ranks relative to this subtree
+    size_t leftSize = getSize(node->left);
+    if (first < leftSize) {
+        selectRangeHelper(node->left, first, std::min(last, leftSize), result);
+    }
+    if (first <= leftSize && leftSize < last) {
+        result.push_back({node->key, node->value});
+    }
+    if (last > leftSize + 1) {
+        size_t rightFirst = first > leftSize + 1 ? first - leftSize - 1 : 0;
+        selectRangeHelper(node->right, rightFirst, last - leftSize - 1, result);
+    }
 }
 
 template<typename K, typename V>
 vector<pair<K, V>> BST<K, V>::inOrderTraversal() const {
+    vector<pair<K, V>> result;
+    result.reserve(nodeCount);
+    inOrderHelper(root, result);
+    return result;
 }
 
 template<typename K, typename V>
 void BST<K, V>::inOrderHelper(shared_ptr<BSTNode> node, vector<pair<K, V>>& result) const {
+    if (!node) {
+        return;
+    }
+    inOrderHelper(node->left, result);
+    result.push_back({node->key, node->value});
+    inOrderHelper(node->right, result);
 }
 
 template<typename K, typename V>
 void BST<K, V>::displayTree() const {
+    if (!root) {
+        cout << "(empty tree)" << endl;
+        return;
+    }
+    displayHelper(root, 0);
 }
 
 template<typename K, typename V>
 void BST<K, V>::displayHelper(shared_ptr<BSTNode> node, int depth) const {
+    if (!node) {
+        return;
+    }
+    displayHelper(node->right, depth + 1);
+    cout << string(depth * 4, ' ') << node->key << endl;
+    displayHelper(node->left, depth + 1);
 }
 
 template<typename K, typename V>
 bool BST<K, V>::isValidBST() const {
+    return isValidBSTHelper(root, nullptr, nullptr);
 }
 
 template<typename K, typename V>
 bool BST<K, V>::isValidBSTHelper(shared_ptr<BSTNode> node, const K* minVal, const K* maxVal) const {
+    if (!node) {
+        return true;
+    }
+    if (minVal && !comparator(*minVal, node->key)) {
+        return false;
+    }
+    if (maxVal && !comparator(node->key, *maxVal)) {
+        return false;
+    }
+    if (node->size != getSize(node->left) + getSize(node->right) + 1) {
+        return false;
+    }
+    return isValidBSTHelper(node->left, minVal, &node->key) &&
+           isValidBSTHelper(node->right, &node->key, maxVal);
 }
 
 template<typename K, typename V>
 void BST<K, V>::updateHeight(shared_ptr<BSTNode> node) {
+    if (!node) {
+        return;
+    }
+    node->height = 1 + std::max(getHeight(node->left), getHeight(node->right));
+    node->size = 1 + getSize(node->left) + getSize(node->right);
 }
 
 template<typename K, typename V>
 int BST<K, V>::getHeight(shared_ptr<BSTNode> node) const {
+    return node ? node->height : 0;
+}
+
+template<typename K, typename V>
+size_t BST<K, V>::getSize(shared_ptr<BSTNode> node) const {
+    return node ? node->size : 0;
 }
 
 template class BST<int, string>;
@@ -5,129 +5,822 @@
 #include <algorithm>
 #include <climits>
 #include <functional>
+#include <thread>
 using namespace std;
 
-CategoryNode::CategoryNode(const string& name) 
-    : categoryName(name), totalPostCount(0) {
+// Holds what a structural change rewrites: the child lists of the nodes it rewires and the
+// parent links of the nodes it moves or removes, exclusively, plus the parent links of every
+// ancestor of them shared, so nothing above the change moves while it runs. The root's parent
+// link is never pinned: the root cannot move. Locks are only tried; on failure the writer
+// releases everything and waits out the contended lock before trying again. A writer therefore
+// never waits on a node lock while holding one, which is what lets posters wait on theirs.
+// Does nothing for single-threaded trees.
+class StructureGuard {
+public:
+    StructureGuard(bool enabled, const CategoryNode* root, vector<shared_ptr<CategoryNode>> rewiredNodes,
+                   vector<shared_ptr<CategoryNode>> movedNodes = {}) : detached(false) {
+        if (!enabled) {
+            return;
+        }
+        rewired = distinct(move(rewiredNodes));
+        moved = distinct(move(movedNodes));
+        for (const auto& node : moved) {
+            node->writersWaiting++;
+        }
+        for (;;) {
+            shared_ptr<CategoryNode> contendedNode;
+            shared_mutex* contended = nullptr;
+            bool exclusive = false;
+            if (tryAcquire(root, contendedNode, contended, exclusive)) {
+                return;
+            }
+            release();
+            if (!contended) {
+                detached = true;
+                return;
+            }
+            if (exclusive) {
+                contended->lock();
+                contended->unlock();
+            } else {
+                contended->lock_shared();
+                contended->unlock_shared();
+            }
+        }
+    }
+
+    ~StructureGuard() {
+        release();
+        for (const auto& node : moved) {
+            node->writersWaiting--;
+        }
+    }
+
+    // False if a node had been detached from the root (removed); the guard then holds nothing
+    bool attached() const { return !detached; }
+
+private:
+    using HeldLock = pair<shared_ptr<CategoryNode>, shared_mutex*>;  // the node keeps its lock alive
+
+    vector<shared_ptr<CategoryNode>> rewired;
+    vector<shared_ptr<CategoryNode>> moved;
+    vector<HeldLock> exclusiveHeld;
+    vector<HeldLock> sharedHeld;
+    bool detached;
+
+    static vector<shared_ptr<CategoryNode>> distinct(vector<shared_ptr<CategoryNode>> nodes) {
+        sort(nodes.begin(), nodes.end());
+        nodes.erase(unique(nodes.begin(), nodes.end()), nodes.end());
+        return nodes;
+    }
+
+    bool pinned(const CategoryNode* node) const {
+        auto same = [node](const HeldLock& held) { return held.second == &node->parentLock; };
+        return any_of(exclusiveHeld.begin(), exclusiveHeld.end(), same) || any_of(sharedHeld.begin(), sharedHeld.end(), same);
+    }
+
+    bool tryExclusive(const shared_ptr<CategoryNode>& node, shared_mutex& lock,
+                      shared_ptr<CategoryNode>& contendedNode, shared_mutex*& contended) {
+        if (!lock.try_lock()) {
+            contendedNode = node;
+            contended = &lock;
+            return false;
+        }
+        exclusiveHeld.emplace_back(node, &lock);
+        return true;
+    }
+
+    bool tryAcquire(const CategoryNode* root, shared_ptr<CategoryNode>& contendedNode, shared_mutex*& contended,
+                    bool& exclusive) {
+        exclusive = true;
+        for (const auto& node : rewired) {
+            if (!tryExclusive(node, node->lock, contendedNode, contended)) {
+                return false;
+            }
+        }
+        for (const auto& node : moved) {
+            if (!tryExclusive(node, node->parentLock, contendedNode, contended)) {
+                return false;
+            }
+        }
+        exclusive = false;
+        for (const auto* group : {&rewired, &moved}) {
+            for (const auto& node : *group) {
+                // Each parent link is read while it is pinned, so the walk follows one consistent path
+                for (shared_ptr<CategoryNode> current = node; current.get() != root;) {
+                    if (!pinned(current.get())) {
+                        if (!current->parentLock.try_lock_shared()) {
+                            contendedNode = current;
+                            contended = &current->parentLock;
+                            return false;
+                        }
+                        sharedHeld.emplace_back(current, &current->parentLock);
+                    }
+                    shared_ptr<CategoryNode> parent = current->parent.lock();
+                    if (!parent) {
+                        return false;
+                    }
+                    current = move(parent);
+                }
+            }
+        }
+        return true;
+    }
+
+    void release() {
+        for (const auto& held : exclusiveHeld) {
+            held.second->unlock();
+        }
+        for (const auto& held : sharedHeld) {
+            held.second->unlock_shared();
+        }
+        exclusiveHeld.clear();
+        sharedHeld.clear();
+    }
+};
+
+CategoryNode::CategoryNode(const string& name)
+    : categoryName(name), totalPostCount(0), writersWaiting(0), tourBegin(0), tourEnd(0) {
 }
 
 void CategoryNode::addChild(shared_ptr<CategoryNode> child) {
+    child->parent = shared_from_this();
+    children.push_back(child);
+    adjustPostCount(child->totalPostCount);
+    if (!childIndex.empty()) {
+        childIndex[child->categoryName] = child.get();
+    } else if (children.size() > CHILD_INDEX_THRESHOLD) {
+        for (const auto& c : children) {
+            childIndex[c->categoryName] = c.get();
+        }
+    }
 }
 
 bool CategoryNode::removeChild(const string& childName) {
-}
-
-shared_ptr<CategoryNode> CategoryNode::findChild(const string& childName) const {
+    shared_ptr<CategoryNode> child = findChild(childName);
+    if (!child) {
+        return false;
+    }
+    // Erase in place so the remaining children keep their insertion order
+    children.erase(find(children.begin(), children.end(), child));
+    child->parent.reset();
+    adjustPostCount(-child->totalPostCount);
+    if (!childIndex.empty()) {
+        childIndex.erase(childName);
+        if (children.size() <= CHILD_INDEX_THRESHOLD / 2) {
+            childIndex.clear();
+        }
+    }
+    return true;
+}
+
+shared_ptr<CategoryNode> CategoryNode::findChild(string_view childName) const {
+    if (!childIndex.empty()) {
+        auto it = childIndex.find(childName);
+        return it == childIndex.end() ? nullptr : it->second->shared_from_this();
+    }
+    for (const auto& child : children) {
+        if (child->categoryName == childName) {
+            return child;
+        }
+    }
+    return nullptr;
 }
 
 void CategoryNode::addPost(Post* post) {
+    posts.push_back(post);
+    adjustPostCount(1);
 }
 
 bool CategoryNode::removePost(Post* post) {
+    auto it = find(posts.begin(), posts.end(), post);
+    if (it == posts.end()) {
+        return false;
+    }
+    removePostAt(it - posts.begin());
+    return true;
+}
+
+Post* CategoryNode::removePostAt(size_t slot) {
+    Post* moved = nullptr;
+    if (slot + 1 < posts.size()) {
+        moved = posts.back();
+        posts[slot] = moved;
+    }
+    posts.pop_back();
+    adjustPostCount(-1);
+    return moved;
+}
+
+void CategoryNode::adjustPostCount(int delta) {
+    if (delta == 0) {
+        return;
+    }
+    for (CategoryNode* node = this; node; node = node->parent.lock().get()) {
+        node->totalPostCount.fetch_add(delta, memory_order_relaxed);
+    }
 }
 
 void CategoryNode::updatePostCounts() {
+    totalPostCount = static_cast<int>(posts.size());
+    for (const auto& child : children) {
+        child->updatePostCounts();
+        totalPostCount += child->totalPostCount;
+    }
 }
 
-CategoryTree::CategoryTree() {
+CategoryTree::CategoryTree(bool concurrentMode) : concurrent(concurrentMode), layoutDirty(true) {
     root = make_shared<CategoryNode>("root");
 }
 
+string CategoryTree::canonicalPath(string_view path) const {
+    string canonical;
+    CategoryPathTokenizer tokens(path);
+    for (string_view segment; tokens.next(segment);) {
+        if (!canonical.empty()) {
+            canonical += '_';
+        }
+        canonical += segment;
+    }
+    return canonical;
+}
+
+shared_ptr<CategoryNode> CategoryTree::resolvePath(string_view path) const {
+    shared_ptr<CategoryNode> node = root;
+    CategoryPathTokenizer tokens(path);
+    for (string_view segment; node && tokens.next(segment);) {
+        node = childOf(node, segment);
+    }
+    return node;
+}
+
+shared_ptr<CategoryNode> CategoryTree::childOf(const shared_ptr<CategoryNode>& node, string_view name) const {
+    shared_lock<shared_mutex> nodeGuard(node->lock, defer_lock);
+    if (concurrent) {
+        nodeGuard.lock();
+    }
+    return node->findChild(name);
+}
+
+shared_ptr<CategoryNode> CategoryTree::parentOf(const shared_ptr<CategoryNode>& node) const {
+    shared_lock<shared_mutex> nodeGuard(node->parentLock, defer_lock);
+    if (concurrent) {
+        nodeGuard.lock();
+    }
+    return node->parent.lock();
+}
+
+shared_ptr<CategoryNode> CategoryTree::indexFind(const string& path) const {
+    PathIndexShard& shard = indexShardFor(path);
+    shared_lock<shared_mutex> shardGuard(shard.lock, defer_lock);
+    if (concurrent) {
+        shardGuard.lock();
+    }
+    auto it = shard.nodes.find(path);
+    return it == shard.nodes.end() ? nullptr : it->second;
+}
+
+string CategoryTree::pathOf(const shared_ptr<CategoryNode>& node) const {
+    vector<const string*> names;
+    for (shared_ptr<CategoryNode> current = node; current && current != root; current = current->parent.lock()) {
+        names.push_back(&current->categoryName);
+    }
+    string path;
+    for (auto it = names.rbegin(); it != names.rend(); ++it) {
+        if (!path.empty()) {
+            path += '_';
+        }
+        path += **it;
+    }
+    return path;
+}
+
+void CategoryTree::indexSubtree(const shared_ptr<CategoryNode>& node, const string& path, bool add) {
+    {
+        PathIndexShard& shard = indexShardFor(path);
+        unique_lock<shared_mutex> shardGuard(shard.lock, defer_lock);
+        if (concurrent) {
+            shardGuard.lock();
+        }
+        if (add) {
+            shard.nodes[path] = node;
+        } else {
+            shard.nodes.erase(path);
+        }
+    }
+    if (add) {
+        for (Post* post : node->posts) {
+            post->category = path;  // keep the post's path in step with where it now lives
+        }
+    }
+    for (const auto& child : node->children) {
+        indexSubtree(child, path + "_" + child->categoryName, add);
+    }
+}
+
 bool CategoryTree::addCategory(const string& categoryPath) {
+    if (indexFind(categoryPath)) {
+        return false;
+    }
+    bool created = false;
+    for (int attempt = 0; attempt < MAX_STRUCTURE_RETRIES; ++attempt) {
+        shared_ptr<CategoryNode> current = root;
+        string path;
+        bool displaced = false;
+        CategoryPathTokenizer tokens(categoryPath);
+        for (string_view name; tokens.next(name);) {
+            string parentPath = path;
+            if (!path.empty()) {
+                path += '_';
+            }
+            path += name;
+            shared_ptr<CategoryNode> next = childOf(current, name);
+            if (!next) {
+                StructureGuard guard(concurrent, root.get(), {current});
+                // The parent may have been moved or removed since the walk passed it
+                if (!guard.attached() || pathOf(current) != parentPath) {
+                    displaced = true;
+                    break;
+                }
+                next = current->findChild(name);
+                if (!next) {
+                    next = make_shared<CategoryNode>(string(name));
+                    current->addChild(next);
+                    indexSubtree(next, path, true);
+                    created = true;
+                }
+            }
+            current = next;
+        }
+        if (!displaced) {
+            break;
+        }
+    }
+    if (created) {
+        layoutDirty = true;
+    }
+    return created;
 }
 
 bool CategoryTree::removeCategory(const string& categoryPath) {
+    string expectedPath = canonicalPath(categoryPath);
+    for (int attempt = 0; attempt < MAX_STRUCTURE_RETRIES; ++attempt) {
+        shared_ptr<CategoryNode> node = findCategory(categoryPath);
+        if (!node || node == root) {
+            return false;
+        }
+        shared_ptr<CategoryNode> parent = parentOf(node);
+        if (!parent) {
+            continue;
+        }
+        StructureGuard guard(concurrent, root.get(), {parent}, {node});
+        if (!guard.attached() || node->parent.lock() != parent || pathOf(node) != expectedPath) {
+            continue;  // moved or removed between the lookup and the locks; resolve the path again
+        }
+        indexSubtree(node, expectedPath, false);
+        // Drop back-references before the nodes they point at can be released
+        for (PreOrderIterator it(node), end; it != end; ++it) {
+            for (Post* post : (*it)->posts) {
+                PostSlotShard& shard = shardFor(post);
+                unique_lock<mutex> slotGuard(shard.lock, defer_lock);
+                if (concurrent) {
+                    slotGuard.lock();
+                }
+                shard.slots.erase(post);
+            }
+        }
+        parent->removeChild(node->categoryName);
+        layoutDirty = true;
+        return true;
+    }
+    return false;
 }
 
 bool CategoryTree::moveCategory(const string& fromPath, const string& toPath) {
+    for (int attempt = 0; attempt < MAX_STRUCTURE_RETRIES; ++attempt) {
+        shared_ptr<CategoryNode> node = findCategory(fromPath);
+        shared_ptr<CategoryNode> target = findCategory(toPath);
+        if (!node || !target || node == root) {
+            return false;
+        }
+        shared_ptr<CategoryNode> oldParent = parentOf(node);
+        if (!oldParent) {
+            continue;
+        }
+        // Posters inside the moved subtree pin node's parent link, so its total is stable while we hold it
+        StructureGuard guard(concurrent, root.get(), {oldParent, target}, {node});
+        if (!guard.attached() || node->parent.lock() != oldParent || pathOf(node) != canonicalPath(fromPath) ||
+            (target != root && pathOf(target) != canonicalPath(toPath))) {
+            continue;  // moved or removed between the lookups and the locks; resolve the paths again
+        }
+        if (target->findChild(node->categoryName)) {
+            return false;
+        }
+        // Refuse to move a category underneath itself
+        for (shared_ptr<CategoryNode> ancestor = target; ancestor; ancestor = ancestor->parent.lock()) {
+            if (ancestor == node) {
+                return false;
+            }
+        }
+        // Index keys come from the nodes, not the caller's strings: "root" or "A__B" name the same place
+        indexSubtree(node, pathOf(node), false);
+        oldParent->removeChild(node->categoryName);
+        target->addChild(node);
+        indexSubtree(node, pathOf(node), true);
+        layoutDirty = true;
+        return true;
+    }
+    return false;
 }
 
 shared_ptr<CategoryNode> CategoryTree::findCategory(const string& categoryPath) const {
+    if (categoryPath.empty() || categoryPath == "root") {
+        return root;
+    }
+    if (shared_ptr<CategoryNode> node = indexFind(categoryPath)) {
+        return node;
+    }
+    // Not in canonical form (e.g. "A__B" or "A_B_"): walk the segments instead of building a key
+    return resolvePath(categoryPath);
+}
+
+bool CategoryTree::lockAncestry(const shared_ptr<CategoryNode>& node, vector<shared_ptr<CategoryNode>>& chain) const {
+    // Pins parent links bottom-up, stopping below the root: the root never moves, so posts into
+    // unrelated subtrees share no lock. Structural writers never wait while holding a node lock,
+    // so a poster may. It backs off from nodes a writer is about to move or remove, so a stream
+    // of posters cannot starve the writer, but only MAX_STRUCTURE_RETRIES times; after that it
+    // waits its turn.
+    for (int attempt = 0;; ++attempt) {
+        bool deferToWriters = attempt < MAX_STRUCTURE_RETRIES;
+        chain.clear();
+        shared_ptr<CategoryNode> current = node;
+        for (;;) {
+            if (current == root) {
+                return true;
+            }
+            if (deferToWriters && current->writersWaiting.load() > 0) {
+                break;
+            }
+            current->parentLock.lock_shared();
+            chain.push_back(current);
+            shared_ptr<CategoryNode> parent = current->parent.lock();
+            if (!parent) {
+                unlockAncestry(chain);
+                return false;  // the category has been removed
+            }
+            current = move(parent);
+        }
+        unlockAncestry(chain);
+        this_thread::yield();
+    }
+}
+
+void CategoryTree::unlockAncestry(vector<shared_ptr<CategoryNode>>& chain) {
+    for (const auto& node : chain) {
+        node->parentLock.unlock_shared();
+    }
+    chain.clear();
 }
 
 void CategoryTree::addPost(Post* post) {
+    if (!post) {
+        return;
+    }
+    if (concurrent) {
+        addPostConcurrent(post);
+        return;
+    }
+    PostSlotShard& shard = shardFor(post);
+    if (shard.slots.count(post)) {
+        return;  // a post lives in exactly one category
+    }
+    shared_ptr<CategoryNode> node = findCategory(post->category);
+    if (!node) {
+        addCategory(post->category);
+        node = findCategory(post->category);
+    }
+    node->addPost(post);
+    shard.slots[post] = {node.get(), node->posts.size() - 1};
+    layoutDirty = true;
+}
+
+void CategoryTree::addPostConcurrent(Post* post) {
+    PostSlotShard& shard = shardFor(post);
+    {
+        // Reserve the entry so the same post cannot be added twice concurrently
+        lock_guard<mutex> slotGuard(shard.lock);
+        if (!shard.slots.emplace(post, pair<CategoryNode*, size_t>(nullptr, 0)).second) {
+            return;
+        }
+    }
+    vector<shared_ptr<CategoryNode>> chain;
+    for (int attempt = 0; attempt < MAX_STRUCTURE_RETRIES; ++attempt) {
+        // findCategory falls back to the live links, so a lagging index cannot keep this from resolving
+        shared_ptr<CategoryNode> node = findCategory(post->category);
+        if (!node) {
+            addCategory(post->category);
+            node = findCategory(post->category);
+        }
+        if (!node || !lockAncestry(node, chain)) {
+            continue;  // removed after the lookup; resolve the path again
+        }
+        {
+            lock_guard<mutex> postsGuard(node->postsLock);
+            node->addPost(post);
+            lock_guard<mutex> slotGuard(shard.lock);
+            shard.slots[post] = {node.get(), node->posts.size() - 1};
+        }
+        unlockAncestry(chain);
+        layoutDirty = true;
+        return;
+    }
+    // The category was removed under every attempt: leave the post unfiled
+    lock_guard<mutex> slotGuard(shard.lock);
+    shard.slots.erase(post);
 }
 
 bool CategoryTree::removePost(Post* post) {
+    if (!post) {
+        return false;
+    }
+    if (concurrent) {
+        return removePostConcurrent(post);
+    }
+    PostSlotShard& shard = shardFor(post);
+    auto it = shard.slots.find(post);
+    if (it == shard.slots.end()) {
+        return false;
+    }
+    CategoryNode* node = it->second.first;
+    size_t slot = it->second.second;
+    shard.slots.erase(it);
+    if (Post* moved = node->removePostAt(slot)) {
+        shardFor(moved).slots[moved].second = slot;
+    }
+    layoutDirty = true;
+    return true;
+}
+
+bool CategoryTree::removePostConcurrent(Post* post) {
+    PostSlotShard& shard = shardFor(post);
+    vector<shared_ptr<CategoryNode>> chain;
+    for (int attempt = 0; attempt < MAX_STRUCTURE_RETRIES; ++attempt) {
+        shared_ptr<CategoryNode> node;
+        {
+            lock_guard<mutex> slotGuard(shard.lock);
+            auto it = shard.slots.find(post);
+            if (it == shard.slots.end() || !it->second.first) {
+                return false;
+            }
+            // Safe: removeCategory erases entries before it releases their nodes
+            node = it->second.first->shared_from_this();
+        }
+        if (!lockAncestry(node, chain)) {
+            return false;
+        }
+        bool removed = false;
+        bool relocated = false;
+        {
+            lock_guard<mutex> postsGuard(node->postsLock);
+            size_t slot = 0;
+            {
+                lock_guard<mutex> slotGuard(shard.lock);
+                auto it = shard.slots.find(post);
+                if (it != shard.slots.end() && it->second.first == node.get()) {
+                    slot = it->second.second;
+                    shard.slots.erase(it);
+                    removed = true;
+                } else {
+                    relocated = it != shard.slots.end() && it->second.first;
+                }
+            }
+            if (removed) {
+                if (Post* moved = node->removePostAt(slot)) {
+                    PostSlotShard& movedShard = shardFor(moved);
+                    lock_guard<mutex> movedGuard(movedShard.lock);
+                    movedShard.slots[moved].second = slot;
+                }
+            }
+        }
+        unlockAncestry(chain);
+        if (!relocated) {
+            if (removed) {
+                layoutDirty = true;
+            }
+            return removed;
+        }
+        // Removed and re-added elsewhere between the two lookups: try again at its new node
+    }
+    return false;  // re-filed by other threads on every attempt
 }
 
 vector<Post*> CategoryTree::getPostsInCategory(const string& categoryPath, bool includeSubcategories) const {
+    shared_ptr<CategoryNode> node = findCategory(categoryPath);
+    if (!node) {
+        return {};
+    }
+    if (concurrent) {
+        // Each category is copied under its own locks; the result is not one atomic snapshot
+        vector<Post*> result;
+        vector<shared_ptr<CategoryNode>> pending{node};
+        while (!pending.empty()) {
+            shared_ptr<CategoryNode> current = move(pending.back());
+            pending.pop_back();
+            if (includeSubcategories) {
+                shared_lock<shared_mutex> nodeGuard(current->lock);
+                pending.insert(pending.end(), current->children.rbegin(), current->children.rend());
+            }
+            lock_guard<mutex> postsGuard(current->postsLock);
+            result.insert(result.end(), current->posts.begin(), current->posts.end());
+        }
+        return result;
+    }
+    if (!includeSubcategories) {
+        return node->posts;
+    }
+    if (!layoutDirty) {
+        return vector<Post*>(tourPosts.begin() + node->tourBegin, tourPosts.begin() + node->tourEnd);
+    }
+    vector<Post*> result;
+    result.reserve(node->totalPostCount);
+    for (PreOrderIterator it(node), end; it != end; ++it) {
+        result.insert(result.end(), (*it)->posts.begin(), (*it)->posts.end());
+    }
+    return result;
+}
+
+PostSpan CategoryTree::getPostSpan(const string& categoryPath) const {
+    shared_ptr<CategoryNode> node = findCategory(categoryPath);
+    if (!node) {
+        return PostSpan{nullptr, 0};
+    }
+    if (layoutDirty) {
+        tourPosts.clear();
+        tourPosts.reserve(root->totalPostCount);
+        layoutSubtree(root.get());
+        layoutDirty = false;
+    }
+    return PostSpan{tourPosts.data() + node->tourBegin, node->tourEnd - node->tourBegin};
+}
+
+WorkStealingPool& CategoryTree::workerPool() const {
+    call_once(poolOnce, [this]() { pool.reset(new WorkStealingPool()); });
+    return *pool;
+}
+
+void CategoryTree::layoutSubtree(CategoryNode* node) const {
+    node->tourBegin = tourPosts.size();
+    tourPosts.insert(tourPosts.end(), node->posts.begin(), node->posts.end());
+    for (const auto& child : node->children) {
+        layoutSubtree(child.get());
+    }
+    node->tourEnd = tourPosts.size();
 }
 
 void CategoryTree::displayTree() const {
+    function<void(const shared_ptr<CategoryNode>&, int)> print = [&](const shared_ptr<CategoryNode>& node, int depth) {
+        cout << string(depth * 2, ' ') << node->categoryName
+             << " (" << node->posts.size() << " direct, " << node->totalPostCount << " total)" << endl;
+        for (const auto& child : node->children) {
+            print(child, depth + 1);
+        }
+    };
+    print(root, 0);
 }
 
-CategoryTree::PreOrderIterator::PreOrderIterator(shared_ptr<CategoryNode> root) {
+CategoryTree::PreOrderIterator::PreOrderIterator(shared_ptr<CategoryNode> root) : current(root) {
 }
 
 CategoryTree::PreOrderIterator::PreOrderIterator() : current(nullptr) {
 }
 
 shared_ptr<CategoryNode> CategoryTree::PreOrderIterator::operator*() const {
+    return current;
 }
 
 CategoryTree::PreOrderIterator& CategoryTree::PreOrderIterator::operator++() {
+    if (!current) {
+        return *this;
+    }
+    // Push children right-to-left so the leftmost child is visited next
+    for (auto it = current->children.rbegin(); it != current->children.rend(); ++it) {
+        stack.push_back(*it);
+    }
+    if (stack.empty()) {
+        current = nullptr;
+    } else {
+        current = stack.back();
+        stack.pop_back();
+    }
+    return *this;
 }
 
 bool CategoryTree::PreOrderIterator::operator!=(const PreOrderIterator& other) const {
+    return !(*this == other);
 }
 
 bool CategoryTree::PreOrderIterator::operator==(const PreOrderIterator& other) const {
+    return current == other.current;
 }
 
-CategoryTree::PostOrderIterator::PostOrderIterator(shared_ptr<CategoryNode> root) 
+CategoryTree::PostOrderIterator::PostOrderIterator(shared_ptr<CategoryNode> root)
     : current(nullptr), lastVisited(nullptr) {
+    if (root) {
+        stack.push_back(root);
+        ++(*this);
+    }
 }
 
-CategoryTree::PostOrderIterator::PostOrderIterator() 
+CategoryTree::PostOrderIterator::PostOrderIterator()
     : current(nullptr), lastVisited(nullptr) {
 }
 
 shared_ptr<CategoryNode> CategoryTree::PostOrderIterator::operator*() const {
+    return current;
 }
 
 CategoryTree::PostOrderIterator& CategoryTree::PostOrderIterator::operator++() {
+    // A node is ready once it is a leaf or its last child was the previous node emitted
+    while (!stack.empty()) {
+        shared_ptr<CategoryNode> top = stack.back();
+        if (top->children.empty() || lastVisited == top->children.back()) {
+            stack.pop_back();
+            current = lastVisited = top;
+            return *this;
+        }
+        for (auto it = top->children.rbegin(); it != top->children.rend(); ++it) {
+            stack.push_back(*it);
+        }
+    }
+    current = nullptr;
+    return *this;
 }
 
 bool CategoryTree::PostOrderIterator::operator!=(const PostOrderIterator& other) const {
+    return !(*this == other);
 }
 
 bool CategoryTree::PostOrderIterator::operator==(const PostOrderIterator& other) const {
+    return current == other.current;
 }
 
-CategoryTree::BreadthFirstIterator::BreadthFirstIterator(shared_ptr<CategoryNode> root) 
+CategoryTree::BreadthFirstIterator::BreadthFirstIterator(shared_ptr<CategoryNode> root)
     : currentIndex(0) {
+    if (root) {
+        queue.push_back(root);
+    } else {
+        currentIndex = SIZE_MAX;
+    }
 }
 
 CategoryTree::BreadthFirstIterator::BreadthFirstIterator() : currentIndex(SIZE_MAX) {
 }
 
 shared_ptr<CategoryNode> CategoryTree::BreadthFirstIterator::operator*() const {
+    return currentIndex < queue.size() ? queue[currentIndex] : nullptr;
 }
 
 CategoryTree::BreadthFirstIterator& CategoryTree::BreadthFirstIterator::operator++() {
+    if (currentIndex >= queue.size()) {
+        return *this;
+    }
+    const auto& children = queue[currentIndex]->children;
+    queue.insert(queue.end(), children.begin(), children.end());
+    if (++currentIndex == queue.size()) {
+        queue.clear();
+        currentIndex = SIZE_MAX;
+    }
+    return *this;
 }
 
 bool CategoryTree::BreadthFirstIterator::operator!=(const BreadthFirstIterator& other) const {
+    return !(*this == other);
 }
 
 bool CategoryTree::BreadthFirstIterator::operator==(const BreadthFirstIterator& other) const {
+    return **this == *other;
 }
 
 CategoryTree::PreOrderIterator CategoryTree::preOrderBegin() const {
+    return PreOrderIterator(root);
 }
 
 CategoryTree::PreOrderIterator CategoryTree::preOrderEnd() const {
+    return PreOrderIterator();
 }
 
 CategoryTree::PostOrderIterator CategoryTree::postOrderBegin() const {
+    return PostOrderIterator(root);
 }
 
 CategoryTree::PostOrderIterator CategoryTree::postOrderEnd() const {
+    return PostOrderIterator();
 }
 
 CategoryTree::BreadthFirstIterator CategoryTree::breadthFirstBegin() const {
+    return BreadthFirstIterator(root);
 }
 
 CategoryTree::BreadthFirstIterator CategoryTree::breadthFirstEnd() const {
-}
\ No newline at end of file
+    return BreadthFirstIterator();
+}
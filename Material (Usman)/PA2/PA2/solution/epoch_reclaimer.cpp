@@ -0,0 +1,80 @@
+#include "../headers/epoch_reclaimer.h"
+#include <algorithm>
+#include <functional>
+#include <thread>
+using namespace std;
+
+EpochReclaimer::EpochReclaimer() : globalEpoch(1) {
+    for (Slot& slot : slots) {
+        slot.epoch.store(IDLE);
+        slot.claimed.store(false);
+    }
+}
+
+EpochReclaimer::~EpochReclaimer() {
+    // Owners must ensure no ReadGuard outlives the reclaimer
+    retired.clear();
+}
+
+EpochReclaimer::ReadGuard::ReadGuard(EpochReclaimer& reclaimer) : owner(reclaimer), slot(0) {
+    // Start probing at a per-thread offset so threads rarely collide on a slot
+    size_t start = hash<thread::id>()(this_thread::get_id()) % MAX_READERS;
+    for (size_t attempt = 0;; ++attempt) {
+        size_t candidate = (start + attempt) % MAX_READERS;
+        bool expected = false;
+        if (!owner.slots[candidate].claimed.load(memory_order_relaxed) &&
+            owner.slots[candidate].claimed.compare_exchange_strong(expected, true)) {
+            slot = candidate;
+            break;
+        }
+        if (attempt % MAX_READERS == MAX_READERS - 1) {
+            this_thread::yield();
+        }
+    }
+    // seq_cst store: the pin must be visible before the reader loads any published pointer
+    owner.slots[slot].epoch.store(owner.globalEpoch.load());
+}
+
+EpochReclaimer::ReadGuard::~ReadGuard() {
+    owner.slots[slot].epoch.store(IDLE, memory_order_release);
+    owner.slots[slot].claimed.store(false, memory_order_release);
+}
+
+void EpochReclaimer::retire(shared_ptr<const void> object) {
+    // Readers pinned at or before this epoch may still hold the object
+    uint64_t epoch = globalEpoch.fetch_add(1);
+    lock_guard<mutex> lock(retiredMutex);
+    retired.push_back({epoch, move(object)});
+}
+
+uint64_t EpochReclaimer::oldestPinnedEpoch() const {
+    uint64_t oldest = UINT64_MAX;
+    for (const Slot& slot : slots) {
+        uint64_t epoch = slot.epoch.load();
+        if (epoch != IDLE) {
+            oldest = min(oldest, epoch);
+        }
+    }
+    return oldest;
+}
+
+size_t EpochReclaimer::reclaim() {
+    uint64_t oldest = oldestPinnedEpoch();
+    vector<shared_ptr<const void>> freed;  // released outside the lock
+    {
+        lock_guard<mutex> lock(retiredMutex);
+        auto safe = partition(retired.begin(), retired.end(), [oldest](const pair<uint64_t, shared_ptr<const void>>& entry) {
+            return entry.first >= oldest;
+        });
+        for (auto it = safe; it != retired.end(); ++it) {
+            freed.push_back(move(it->second));
+        }
+        retired.erase(safe, retired.end());
+    }
+    return freed.size();
+}
+
+size_t EpochReclaimer::pendingCount() const {
+    lock_guard<mutex> lock(retiredMutex);
+    return retired.size();
+}
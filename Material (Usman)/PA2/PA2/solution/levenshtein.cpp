@@ -0,0 +1,62 @@
+#include "../headers/levenshtein.h"
+#include <algorithm>
+#include <vector>
+using namespace std;
+
+LevenshteinMatcher::LevenshteinMatcher(const string& pattern) : pattern(pattern) {
+    peq.fill(0);
+    if (pattern.size() <= 64) {
+        for (size_t i = 0; i < pattern.size(); ++i) {
+            peq[static_cast<unsigned char>(pattern[i])] |= uint64_t(1) << i;
+        }
+    }
+}
+
+int LevenshteinMatcher::distance(const string& text) const {
+    size_t m = pattern.size();
+    if (m == 0) {
+        return static_cast<int>(text.size());
+    }
+    if (m > 64) {
+        return dynamicDistance(pattern, text);
+    }
+
+    // Column of vertical deltas encoded as +1 (pv) / -1 (mv) bit vectors
+    uint64_t pv = m == 64 ? ~uint64_t(0) : (uint64_t(1) << m) - 1;
+    uint64_t mv = 0;
+    uint64_t last = uint64_t(1) << (m - 1);
+    int score = static_cast<int>(m);
+    for (char c : text) {
+        uint64_t eq = peq[static_cast<unsigned char>(c)];
+        uint64_t xv = eq | mv;
+        uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+        uint64_t ph = mv | ~(xh | pv);
+        uint64_t mh = pv & xh;
+        if (ph & last) {
+            score++;
+        } else if (mh & last) {
+            score--;
+        }
+        ph = (ph << 1) | 1;  // row 0 grows by one per text character
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+    }
+    return score;
+}
+
+int LevenshteinMatcher::dynamicDistance(const string& a, const string& b) {
+    vector<int> prev(b.size() + 1), curr(b.size() + 1);
+    for (size_t j = 0; j <= b.size(); ++j) {
+        prev[j] = static_cast<int>(j);
+    }
+    for (size_t i = 1; i <= a.size(); ++i) {
+        curr[0] = static_cast<int>(i);
+        for (size_t j = 1; j <= b.size(); ++j) {
+            int cost = a[i - 1] == b[j - 1] ? 0 : 1;
+            curr[j] = min({prev[j] + 1, curr[j - 1] + 1, prev[j - 1] + cost});
+        }
+        swap(prev, curr);
+    }
+    return prev[b.size()];
+}
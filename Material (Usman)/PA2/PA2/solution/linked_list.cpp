@@ -8,51 +8,109 @@ LinkedList<T>::LinkedList() : _head(nullptr), _tail(nullptr), _size(0) {}
 template <typename T>
 LinkedList<T>::~LinkedList()
 {
+    clear();
 }
 
 template <typename T>
 typename LinkedList<T>::Node *LinkedList<T>::push_back(const T &val)
 {
+    Node *node = new Node(val);
+    node->prev = _tail;
+    if (_tail)
+        _tail->next = node;
+    else
+        _head = node;
+    _tail = node;
+    _size++;
+    return node;
 }
 
 template <typename T>
 typename LinkedList<T>::Node *LinkedList<T>::push_front(const T &val)
 {
+    Node *node = new Node(val);
+    node->next = _head;
+    if (_head)
+        _head->prev = node;
+    else
+        _tail = node;
+    _head = node;
+    _size++;
+    return node;
 }
 
 template <typename T>
 void LinkedList<T>::insert_after(Node *pos, const T &val)
 {
+    if (!pos || pos == _tail)
+    {
+        push_back(val);
+        return;
+    }
+    Node *node = new Node(val);
+    node->prev = pos;
+    node->next = pos->next;
+    pos->next->prev = node;
+    pos->next = node;
+    _size++;
 }
 
 template <typename T>
 void LinkedList<T>::remove(Node *node)
 {
+    if (!node)
+        return;
+    if (node->prev)
+        node->prev->next = node->next;
+    else
+        _head = node->next;
+    if (node->next)
+        node->next->prev = node->prev;
+    else
+        _tail = node->prev;
+    delete node;
+    _size--;
 }
 
 template <typename T>
 typename LinkedList<T>::Node *LinkedList<T>::find(function<bool(const T &)> pred)
 {
+    for (Node *cur = _head; cur; cur = cur->next)
+        if (pred(cur->data))
+            return cur;
+    return nullptr;
 }
 
 template <typename T>
 typename LinkedList<T>::Node *LinkedList<T>::head() const
 {
+    return _head;
 }
 
 template <typename T>
 typename LinkedList<T>::Node *LinkedList<T>::tail() const
 {
+    return _tail;
 }
 
 template <typename T>
 size_t LinkedList<T>::size() const
 {
+    return _size;
 }
 
 template <typename T>
 void LinkedList<T>::clear()
 {
+    Node *cur = _head;
+    while (cur)
+    {
+        Node *next = cur->next;
+        delete cur;
+        cur = next;
+    }
+    _head = _tail = nullptr;
+    _size = 0;
 }
 
 template class LinkedList<int>;
@@ -0,0 +1,258 @@
+#include "../headers/persistent_avl.h"
+#include <algorithm>
+#include <cstdlib>
+using namespace std;
+
+template<typename K, typename V>
+PersistentAVL<K, V>::Node::Node(const K& k, const V& v, shared_ptr<const Node> l, shared_ptr<const Node> r)
+    : key(k), value(v), left(move(l)), right(move(r)) {
+    height = 1 + std::max(heightOf(left.get()), heightOf(right.get()));
+    size = 1 + sizeOf(left.get()) + sizeOf(right.get());
+}
+
+template<typename K, typename V>
+typename PersistentAVL<K, V>::NodePtr PersistentAVL<K, V>::balance(const K& key, const V& value, const NodePtr& left, const NodePtr& right) {
+    int leftHeight = heightOf(left.get());
+    int rightHeight = heightOf(right.get());
+    if (leftHeight > rightHeight + 1) {
+        if (heightOf(left->left.get()) >= heightOf(left->right.get())) {
+            // Single right rotation
+            return make_shared<const Node>(left->key, left->value, left->left,
+                                           make_shared<const Node>(key, value, left->right, right));
+        }
+        const Node* pivot = left->right.get();
+        return make_shared<const Node>(pivot->key, pivot->value,
+                                       make_shared<const Node>(left->key, left->value, left->left, pivot->left),
+                                       make_shared<const Node>(key, value, pivot->right, right));
+    }
+    if (rightHeight > leftHeight + 1) {
+        if (heightOf(right->right.get()) >= heightOf(right->left.get())) {
+            // Single left rotation
+            return make_shared<const Node>(right->key, right->value,
+                                           make_shared<const Node>(key, value, left, right->left), right->right);
+        }
+        const Node* pivot = right->left.get();
+        return make_shared<const Node>(pivot->key, pivot->value,
+                                       make_shared<const Node>(key, value, left, pivot->left),
+                                       make_shared<const Node>(right->key, right->value, pivot->right, right->right));
+    }
+    return make_shared<const Node>(key, value, left, right);
+}
+
+template<typename K, typename V>
+typename PersistentAVL<K, V>::NodePtr PersistentAVL<K, V>::insertHelper(const NodePtr& node, const K& key, const V& value, bool& inserted) {
+    if (!node) {
+        inserted = true;
+        return make_shared<const Node>(key, value, nullptr, nullptr);
+    }
+    if (key < node->key) {
+        NodePtr left = insertHelper(node->left, key, value, inserted);
+        return inserted ? balance(node->key, node->value, left, node->right) : node;
+    }
+    if (node->key < key) {
+        NodePtr right = insertHelper(node->right, key, value, inserted);
+        return inserted ? balance(node->key, node->value, node->left, right) : node;
+    }
+    return node;  // duplicates are ignored
+}
+
+template<typename K, typename V>
+typename PersistentAVL<K, V>::NodePtr PersistentAVL<K, V>::assignHelper(const NodePtr& node, const K& key, const V& value) {
+    if (!node) {
+        return make_shared<const Node>(key, value, nullptr, nullptr);
+    }
+    if (key < node->key) {
+        return balance(node->key, node->value, assignHelper(node->left, key, value), node->right);
+    }
+    if (node->key < key) {
+        return balance(node->key, node->value, node->left, assignHelper(node->right, key, value));
+    }
+    return make_shared<const Node>(key, value, node->left, node->right);
+}
+
+template<typename K, typename V>
+typename PersistentAVL<K, V>::NodePtr PersistentAVL<K, V>::removeMin(const NodePtr& node, NodePtr& minNode) {
+    if (!node->left) {
+        minNode = node;
+        return node->right;
+    }
+    NodePtr left = removeMin(node->left, minNode);
+    return balance(node->key, node->value, left, node->right);
+}
+
+template<typename K, typename V>
+typename PersistentAVL<K, V>::NodePtr PersistentAVL<K, V>::removeHelper(const NodePtr& node, const K& key, bool& removed) {
+    if (!node) {
+        return node;
+    }
+    if (key < node->key) {
+        NodePtr left = removeHelper(node->left, key, removed);
+        return removed ? balance(node->key, node->value, left, node->right) : node;
+    }
+    if (node->key < key) {
+        NodePtr right = removeHelper(node->right, key, removed);
+        return removed ? balance(node->key, node->value, node->left, right) : node;
+    }
+    removed = true;
+    if (!node->left) {
+        return node->right;
+    }
+    if (!node->right) {
+        return node->left;
+    }
+    NodePtr successor;
+    NodePtr right = removeMin(node->right, successor);
+    return balance(successor->key, successor->value, node->left, right);
+}
+
+template<typename K, typename V>
+PersistentAVL<K, V> PersistentAVL<K, V>::insert(const K& key, const V& value, bool* inserted) const {
+    bool changed = false;
+    NodePtr newRoot = insertHelper(root, key, value, changed);
+    if (inserted) *inserted = changed;
+    return PersistentAVL(newRoot);
+}
+
+template<typename K, typename V>
+PersistentAVL<K, V> PersistentAVL<K, V>::remove(const K& key, bool* removed) const {
+    bool changed = false;
+    NodePtr newRoot = removeHelper(root, key, changed);
+    if (removed) *removed = changed;
+    return PersistentAVL(newRoot);
+}
+
+template<typename K, typename V>
+PersistentAVL<K, V> PersistentAVL<K, V>::assign(const K& key, const V& value) const {
+    return PersistentAVL(assignHelper(root, key, value));
+}
+
+template<typename K, typename V>
+const V* PersistentAVL<K, V>::find(const K& key) const {
+    const Node* node = root.get();
+    while (node) {
+        if (key < node->key) {
+            node = node->left.get();
+        } else if (node->key < key) {
+            node = node->right.get();
+        } else {
+            return &node->value;
+        }
+    }
+    return nullptr;
+}
+
+template<typename K, typename V>
+size_t PersistentAVL<K, V>::rank(const K& key) const {
+    size_t count = 0;
+    const Node* node = root.get();
+    while (node) {
+        if (node->key < key) {
+            count += sizeOf(node->left.get()) + 1;
+            node = node->right.get();
+        } else {
+            node = node->left.get();
+        }
+    }
+    return count;
+}
+
+template<typename K, typename V>
+size_t PersistentAVL<K, V>::countRange(const K& minKey, const K& maxKey) const {
+    if (maxKey < minKey) {
+        return 0;
+    }
+    size_t atMostMax = 0;
+    const Node* node = root.get();
+    while (node) {
+        if (maxKey < node->key) {
+            node = node->left.get();
+        } else {
+            atMostMax += sizeOf(node->left.get()) + 1;
+            node = node->right.get();
+        }
+    }
+    return atMostMax - rank(minKey);
+}
+
+template<typename K, typename V>
+vector<pair<K, V>> PersistentAVL<K, V>::findRange(const K& minKey, const K& maxKey) const {
+    vector<pair<K, V>> result;
+    if (!(maxKey < minKey)) {
+        rangeHelper(root.get(), minKey, maxKey, result);
+    }
+    return result;
+}
+
+template<typename K, typename V>
+void PersistentAVL<K, V>::rangeHelper(const Node* node, const K& minKey, const K& maxKey, vector<pair<K, V>>& result) {
+    if (!node) {
+        return;
+    }
+    bool aboveMin = !(node->key < minKey);
+    bool belowMax = !(maxKey < node->key);
+    if (aboveMin) rangeHelper(node->left.get(), minKey, maxKey, result);
+    if (aboveMin && belowMax) result.push_back({node->key, node->value});
+    if (belowMax) rangeHelper(node->right.get(), minKey, maxKey, result);
+}
+
+template<typename K, typename V>
+vector<pair<K, V>> PersistentAVL<K, V>::selectRange(size_t first, size_t count) const {
+    vector<pair<K, V>> result;
+    size_t total = size();
+    if (first >= total || count == 0) {
+        return result;
+    }
+    size_t last = first + std::min(count, total - first);
+    result.reserve(last - first);
+    selectRangeHelper(root.get(), first, last, result);
+    return result;
+}
+
+template<typename K, typename V>
+void PersistentAVL<K, V>::selectRangeHelper(const Node* node, size_t first, size_t last, vector<pair<K, V>>& result) {
+    if (!node || first >= last) {
+        return;
+    }
+    size_t leftSize = sizeOf(node->left.get());
+    if (first < leftSize) {
+        selectRangeHelper(node->left.get(), first, std::min(last, leftSize), result);
+    }
+    if (first <= leftSize && leftSize < last) {
+        result.push_back({node->key, node->value});
+    }
+    if (last > leftSize + 1) {
+        size_t rightFirst = first > leftSize + 1 ? first - leftSize - 1 : 0;
+        selectRangeHelper(node->right.get(), rightFirst, last - leftSize - 1, result);
+    }
+}
+
+template<typename K, typename V>
+vector<pair<K, V>> PersistentAVL<K, V>::inOrderTraversal() const {
+    return selectRange(0, size());
+}
+
+template<typename K, typename V>
+bool PersistentAVL<K, V>::isValidAVL() const {
+    return isValidHelper(root.get(), nullptr, nullptr);
+}
+
+template<typename K, typename V>
+bool PersistentAVL<K, V>::isValidHelper(const Node* node, const K* minVal, const K* maxVal) {
+    if (!node) {
+        return true;
+    }
+    if ((minVal && !(*minVal < node->key)) || (maxVal && !(node->key < *maxVal))) {
+        return false;
+    }
+    int leftHeight = heightOf(node->left.get());
+    int rightHeight = heightOf(node->right.get());
+    if (abs(leftHeight - rightHeight) > 1 || node->height != 1 + std::max(leftHeight, rightHeight) ||
+        node->size != 1 + sizeOf(node->left.get()) + sizeOf(node->right.get())) {
+        return false;
+    }
+    return isValidHelper(node->left.get(), minVal, &node->key) && isValidHelper(node->right.get(), &node->key, maxVal);
+}
+
+template class PersistentAVL<int, string>;
+template class PersistentAVL<string, string>;
+template class PersistentAVL<int, int>;
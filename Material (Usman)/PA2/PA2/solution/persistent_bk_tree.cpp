@@ -0,0 +1,156 @@
+#include "../headers/persistent_bk_tree.h"
+#include <cstdlib>
+using namespace std;
+
+template<typename V>
+const typename PersistentBKTree<V>::Node* PersistentBKTree<V>::descend(const string& key, vector<pair<const Node*, size_t>>& path,
+                                                                      int* distance) const {
+    LevenshteinMatcher matcher(key);
+    const Node* node = root.get();
+    while (node) {
+        int d = matcher.distance(node->key);
+        if (d == 0) {
+            return node;
+        }
+        size_t index = 0;
+        while (index < node->children.size() && node->children[index].first != d) {
+            index++;
+        }
+        path.push_back({node, index});
+        if (index == node->children.size()) {
+            *distance = d;
+            return nullptr;
+        }
+        node = node->children[index].second.get();
+    }
+    return nullptr;
+}
+
+template<typename V>
+typename PersistentBKTree<V>::NodePtr PersistentBKTree<V>::copyPath(const vector<pair<const Node*, size_t>>& path,
+                                                                    NodePtr replacement) {
+    for (size_t i = path.size(); i-- > 0;) {
+        shared_ptr<Node> copy = make_shared<Node>(*path[i].first);
+        copy->children[path[i].second].second = move(replacement);
+        replacement = move(copy);
+    }
+    return replacement;
+}
+
+template<typename V>
+PersistentBKTree<V> PersistentBKTree<V>::insert(const string& key, const V& value, bool* inserted) const {
+    if (inserted) *inserted = true;
+    PersistentBKTree next = *this;
+    vector<pair<const Node*, size_t>> path;
+    int distance = 0;
+    const Node* node = descend(key, path, &distance);
+    if (node) {
+        if (node->alive) {
+            if (inserted) *inserted = false;
+            return next;
+        }
+        // Revive a previously removed entry in place
+        shared_ptr<Node> revived = make_shared<Node>(*node);
+        revived->alive = true;
+        revived->value = value;
+        next.root = copyPath(path, move(revived));
+        next.deadCount--;
+        next.liveCount++;
+        return next;
+    }
+    NodePtr leaf = make_shared<const Node>(key, value);
+    if (path.empty()) {
+        next.root = move(leaf);
+    } else {
+        // The last ancestor has no child at this distance: copy it with the new edge appended
+        shared_ptr<Node> parent = make_shared<Node>(*path.back().first);
+        parent->children.emplace_back(distance, move(leaf));
+        path.pop_back();
+        next.root = copyPath(path, move(parent));
+    }
+    next.liveCount++;
+    return next;
+}
+
+template<typename V>
+PersistentBKTree<V> PersistentBKTree<V>::remove(const string& key, bool* removed) const {
+    vector<pair<const Node*, size_t>> path;
+    int distance = 0;
+    const Node* node = descend(key, path, &distance);
+    if (!node || !node->alive) {
+        if (removed) *removed = false;
+        return *this;
+    }
+    if (removed) *removed = true;
+    PersistentBKTree next;
+    if (deadCount + 1 > liveCount - 1) {
+        // Dead entries would outnumber live ones: reinsert the live entries into a fresh tree
+        vector<pair<string, V>> entries;
+        collectLive(root.get(), entries);
+        for (const auto& entry : entries) {
+            if (entry.first != key) {
+                next = next.insert(entry.first, entry.second);
+            }
+        }
+        return next;
+    }
+    shared_ptr<Node> dead = make_shared<Node>(*node);
+    dead->alive = false;
+    dead->value = V();
+    next.root = copyPath(path, move(dead));
+    next.liveCount = liveCount - 1;
+    next.deadCount = deadCount + 1;
+    return next;
+}
+
+template<typename V>
+const V* PersistentBKTree<V>::find(const string& key) const {
+    vector<pair<const Node*, size_t>> path;
+    int distance = 0;
+    const Node* node = descend(key, path, &distance);
+    return node && node->alive ? &node->value : nullptr;
+}
+
+template<typename V>
+void PersistentBKTree<V>::search(const string& query, int maxDistance, vector<pair<int, V>>& results,
+                                 size_t* visited) const {
+    if (visited) {
+        *visited = 0;
+    }
+    if (!root) {
+        return;
+    }
+    LevenshteinMatcher matcher(query);
+    vector<const Node*> stack = {root.get()};
+    while (!stack.empty()) {
+        const Node* node = stack.back();
+        stack.pop_back();
+        int d = matcher.distance(node->key);
+        if (visited) {
+            (*visited)++;
+        }
+        if (d <= maxDistance && node->alive) {
+            results.push_back({d, node->value});
+        }
+        for (const auto& child : node->children) {
+            if (abs(child.first - d) <= maxDistance) {
+                stack.push_back(child.second.get());
+            }
+        }
+    }
+}
+
+template<typename V>
+void PersistentBKTree<V>::collectLive(const Node* node, vector<pair<string, V>>& entries) {
+    if (!node) {
+        return;
+    }
+    if (node->alive) {
+        entries.push_back({node->key, node->value});
+    }
+    for (const auto& child : node->children) {
+        collectLive(child.second.get(), entries);
+    }
+}
+
+template class PersistentBKTree<int>;
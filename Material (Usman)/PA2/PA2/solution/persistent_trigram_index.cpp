@@ -0,0 +1,71 @@
+#include "../headers/persistent_trigram_index.h"
+using namespace std;
+
+template<typename V>
+PersistentTrigramIndex<V> PersistentTrigramIndex<V>::insert(const string& key, const V& value) const {
+    bool inserted = false;
+    PersistentTrigramIndex next;
+    next.keys = keys.insert(key, value, &inserted);
+    if (!inserted) {
+        return *this;
+    }
+    next.postings = postings;
+    for (uint32_t trigram : TrigramIndex<V>::trigramsOf(key)) {
+        const Postings* list = next.postings.find(trigram);
+        next.postings = next.postings.assign(trigram, (list ? *list : Postings()).insert(key, value));
+    }
+    return next;
+}
+
+template<typename V>
+PersistentTrigramIndex<V> PersistentTrigramIndex<V>::remove(const string& key) const {
+    bool removed = false;
+    PersistentTrigramIndex next;
+    next.keys = keys.remove(key, &removed);
+    if (!removed) {
+        return *this;
+    }
+    next.postings = postings;
+    for (uint32_t trigram : TrigramIndex<V>::trigramsOf(key)) {
+        Postings list = next.postings.find(trigram)->remove(key);
+        next.postings = list.empty() ? next.postings.remove(trigram) : next.postings.assign(trigram, list);
+    }
+    return next;
+}
+
+template<typename V>
+void PersistentTrigramIndex<V>::search(const string& fragment, vector<pair<string, V>>& results, size_t limit,
+                                       size_t* candidates) const {
+    const size_t PAGE = 64;     // keys fetched per selectRange, so a limit stops the walk early
+    const Postings* shortest = &keys;
+    if (fragment.size() >= 3) {
+        for (uint32_t trigram : TrigramIndex<V>::trigramsOf(fragment)) {
+            const Postings* list = postings.find(trigram);
+            if (!list) {
+                shortest = nullptr;     // some trigram occurs in no key at all
+                break;
+            }
+            if (list->size() < shortest->size()) {
+                shortest = list;
+            }
+        }
+    }
+    size_t checked = 0;
+    size_t found = 0;
+    for (size_t first = 0; shortest && first < shortest->size() && (limit == 0 || found < limit); first += PAGE) {
+        for (const auto& entry : shortest->selectRange(first, PAGE)) {
+            checked++;
+            if (entry.first.find(fragment) != string::npos) {
+                results.push_back(entry);
+                if (++found == limit) {
+                    break;
+                }
+            }
+        }
+    }
+    if (candidates) {
+        *candidates = checked;
+    }
+}
+
+template class PersistentTrigramIndex<int>;
@@ -0,0 +1,171 @@
+#include "../headers/radix_trie.h"
+#include <algorithm>
+#include <climits>
+using namespace std;
+
+template<typename V>
+RadixTrie<V>::RadixTrie() : root(new RadixNode("")), keyCount(0) {
+}
+
+template<typename V>
+size_t RadixTrie<V>::childSlot(const RadixNode* node, unsigned char first) const {
+    auto it = lower_bound(node->children.begin(), node->children.end(), first,
+                          [](const unique_ptr<RadixNode>& child, unsigned char c) {
+                              return static_cast<unsigned char>(child->label[0]) < c;
+                          });
+    return it - node->children.begin();
+}
+
+template<typename V>
+typename RadixTrie<V>::RadixNode* RadixTrie<V>::findChild(const RadixNode* node, unsigned char first) const {
+    size_t slot = childSlot(node, first);
+    if (slot < node->children.size() && static_cast<unsigned char>(node->children[slot]->label[0]) == first) {
+        return node->children[slot].get();
+    }
+    return nullptr;
+}
+
+template<typename V>
+bool RadixTrie<V>::insert(const string& key, const V& value) {
+    RadixNode* node = root.get();
+    size_t pos = 0;
+    while (pos < key.size()) {
+        unsigned char first = key[pos];
+        size_t slot = childSlot(node, first);
+        if (slot == node->children.size() || static_cast<unsigned char>(node->children[slot]->label[0]) != first) {
+            unique_ptr<RadixNode> leaf(new RadixNode(key.substr(pos)));
+            leaf->hasValue = true;
+            leaf->value = value;
+            node->children.insert(node->children.begin() + slot, move(leaf));
+            keyCount++;
+            return true;
+        }
+        RadixNode* child = node->children[slot].get();
+        size_t common = 0;
+        while (common < child->label.size() && pos + common < key.size() && child->label[common] == key[pos + common]) {
+            common++;
+        }
+        if (common < child->label.size()) {
+            // Split the edge: the shared part becomes a new intermediate node
+            unique_ptr<RadixNode> middle(new RadixNode(child->label.substr(0, common)));
+            child->label.erase(0, common);
+            middle->children.push_back(move(node->children[slot]));
+            node->children[slot] = move(middle);
+            child = node->children[slot].get();
+        }
+        node = child;
+        pos += common;
+    }
+    if (node->hasValue) {
+        return false;
+    }
+    node->hasValue = true;
+    node->value = value;
+    keyCount++;
+    return true;
+}
+
+template<typename V>
+bool RadixTrie<V>::remove(const string& key) {
+    if (!removeHelper(root.get(), key, 0)) {
+        return false;
+    }
+    keyCount--;
+    return true;
+}
+
+template<typename V>
+bool RadixTrie<V>::removeHelper(RadixNode* node, const string& key, size_t pos) {
+    if (pos == key.size()) {
+        if (!node->hasValue) {
+            return false;
+        }
+        node->hasValue = false;
+        node->value = V();
+        return true;
+    }
+    size_t slot = childSlot(node, key[pos]);
+    if (slot == node->children.size()) {
+        return false;
+    }
+    RadixNode* child = node->children[slot].get();
+    if (key.compare(pos, child->label.size(), child->label) != 0) {
+        return false;
+    }
+    if (!removeHelper(child, key, pos + child->label.size())) {
+        return false;
+    }
+    // Keep the trie compressed: drop empty leaves, fold single-child pass-through nodes
+    if (!child->hasValue && child->children.empty()) {
+        node->children.erase(node->children.begin() + slot);
+    } else if (!child->hasValue && child->children.size() == 1) {
+        unique_ptr<RadixNode> grandchild = move(child->children.front());
+        grandchild->label = child->label + grandchild->label;
+        node->children[slot] = move(grandchild);
+    }
+    return true;
+}
+
+template<typename V>
+V* RadixTrie<V>::find(const string& key) {
+    return const_cast<V*>(static_cast<const RadixTrie*>(this)->find(key));
+}
+
+template<typename V>
+const V* RadixTrie<V>::find(const string& key) const {
+    const RadixNode* node = root.get();
+    size_t pos = 0;
+    while (pos < key.size()) {
+        node = findChild(node, key[pos]);
+        if (!node || key.compare(pos, node->label.size(), node->label) != 0) {
+            return nullptr;
+        }
+        pos += node->label.size();
+    }
+    return node->hasValue ? &node->value : nullptr;
+}
+
+template<typename V>
+void RadixTrie<V>::collectPrefix(const string& prefix, size_t limit, vector<V>& results) const {
+    const RadixNode* node = root.get();
+    size_t pos = 0;
+    while (pos < prefix.size()) {
+        node = findChild(node, prefix[pos]);
+        if (!node) {
+            return;
+        }
+        size_t remaining = prefix.size() - pos;
+        size_t overlap = min(remaining, node->label.size());
+        if (prefix.compare(pos, overlap, node->label, 0, overlap) != 0) {
+            return;
+        }
+        pos += overlap;  // the prefix may end part-way along this edge
+    }
+    size_t cap = limit == 0 ? SIZE_MAX : results.size() + limit;
+    collectHelper(node, cap, results);
+}
+
+template<typename V>
+void RadixTrie<V>::collectHelper(const RadixNode* node, size_t cap, vector<V>& results) const {
+    if (results.size() >= cap) {
+        return;
+    }
+    if (node->hasValue) {
+        results.push_back(node->value);
+    }
+    for (const auto& child : node->children) {
+        if (results.size() >= cap) {
+            return;
+        }
+        collectHelper(child.get(), cap, results);
+    }
+}
+
+template<typename V>
+void RadixTrie<V>::clear() {
+    root.reset(new RadixNode(""));
+    keyCount = 0;
+}
+
+template class RadixTrie<int>;
+template class RadixTrie<string>;
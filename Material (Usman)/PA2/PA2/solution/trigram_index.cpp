@@ -0,0 +1,163 @@
+#include "../headers/trigram_index.h"
+#include <algorithm>
+#include <iterator>
+using namespace std;
+
+template<typename V>
+uint32_t TrigramIndex<V>::packTrigram(const string& text, size_t pos) {
+    return static_cast<uint32_t>(static_cast<unsigned char>(text[pos])) << 16 |
+           static_cast<uint32_t>(static_cast<unsigned char>(text[pos + 1])) << 8 |
+           static_cast<uint32_t>(static_cast<unsigned char>(text[pos + 2]));
+}
+
+template<typename V>
+vector<uint32_t> TrigramIndex<V>::trigramsOf(const string& text) {
+    vector<uint32_t> trigrams;
+    for (size_t pos = 0; pos + 3 <= text.size(); ++pos) {
+        trigrams.push_back(packTrigram(text, pos));
+    }
+    sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    return trigrams;
+}
+
+template<typename V>
+bool TrigramIndex<V>::insert(const string& key, const V& value) {
+    if (idOf.count(key)) {
+        return false;
+    }
+    uint32_t id = static_cast<uint32_t>(entries.size());
+    entries.push_back(Entry{key, value, true});
+    idOf.emplace(key, id);
+    for (uint32_t trigram : trigramsOf(key)) {
+        postings[trigram].push_back(id);    // the largest id so far, so the list stays sorted
+    }
+    return true;
+}
+
+template<typename V>
+bool TrigramIndex<V>::remove(const string& key) {
+    auto found = idOf.find(key);
+    if (found == idOf.end()) {
+        return false;
+    }
+    entries[found->second] = Entry{string(), V(), false};
+    idOf.erase(found);
+    deadCount++;
+    if (deadCount > idOf.size()) {
+        compact();
+    }
+    return true;
+}
+
+template<typename V>
+void TrigramIndex<V>::compact() {
+    // Live entries keep their relative order, so the filtered lists stay sorted
+    const uint32_t DEAD = UINT32_MAX;
+    vector<uint32_t> renumbered(entries.size(), DEAD);
+    size_t live = 0;
+    for (size_t id = 0; id < entries.size(); ++id) {
+        if (entries[id].alive) {
+            renumbered[id] = static_cast<uint32_t>(live);
+            entries[live++] = move(entries[id]);
+        }
+    }
+    entries.resize(live);
+    for (auto& entry : idOf) {
+        entry.second = renumbered[entry.second];
+    }
+    for (auto list = postings.begin(); list != postings.end();) {
+        size_t kept = 0;
+        for (uint32_t id : list->second) {
+            if (renumbered[id] != DEAD) {
+                list->second[kept++] = renumbered[id];
+            }
+        }
+        list->second.resize(kept);
+        list = kept == 0 ? postings.erase(list) : next(list);
+    }
+    deadCount = 0;
+}
+
+template<typename V>
+const V* TrigramIndex<V>::find(const string& key) const {
+    auto found = idOf.find(key);
+    return found == idOf.end() ? nullptr : &entries[found->second].value;
+}
+
+template<typename V>
+void TrigramIndex<V>::search(const string& fragment, vector<pair<string, V>>& results,
+                             size_t* candidates) const {
+    size_t checked = 0;
+    if (candidates) {
+        *candidates = 0;
+    }
+    if (fragment.size() < 3) {
+        for (const Entry& entry : entries) {
+            if (entry.alive) {
+                checked++;
+                if (entry.key.find(fragment) != string::npos) {
+                    results.emplace_back(entry.key, entry.value);
+                }
+            }
+        }
+        if (candidates) {
+            *candidates = checked;
+        }
+        return;
+    }
+
+    vector<const vector<uint32_t>*> lists;
+    for (uint32_t trigram : trigramsOf(fragment)) {
+        auto list = postings.find(trigram);
+        if (list == postings.end()) {
+            return;     // some trigram occurs in no key at all
+        }
+        lists.push_back(&list->second);
+    }
+    sort(lists.begin(), lists.end(), [](const vector<uint32_t>* a, const vector<uint32_t>* b) {
+        return a->size() < b->size();
+    });
+
+    // Shrink the shortest list against the others; each probe resumes where the last one stopped
+    vector<uint32_t> ids = *lists.front();
+    for (size_t i = 1; i < lists.size() && !ids.empty(); ++i) {
+        auto from = lists[i]->begin();
+        size_t kept = 0;
+        for (uint32_t id : ids) {
+            from = lower_bound(from, lists[i]->end(), id);
+            if (from == lists[i]->end()) {
+                break;
+            }
+            if (*from == id) {
+                ids[kept++] = id;
+            }
+        }
+        ids.resize(kept);
+    }
+
+    // Sharing every trigram does not imply containment ("abcab" vs "bcabc"), so verify
+    for (uint32_t id : ids) {
+        const Entry& entry = entries[id];
+        if (!entry.alive) {
+            continue;
+        }
+        checked++;
+        if (entry.key.find(fragment) != string::npos) {
+            results.emplace_back(entry.key, entry.value);
+        }
+    }
+    if (candidates) {
+        *candidates = checked;
+    }
+}
+
+template<typename V>
+void TrigramIndex<V>::clear() {
+    entries.clear();
+    deadCount = 0;
+    idOf.clear();
+    postings.clear();
+}
+
+template class TrigramIndex<int>;
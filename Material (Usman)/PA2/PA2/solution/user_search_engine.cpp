@@ -4,52 +4,348 @@
 #include <iostream>
 using namespace std;
 
-UserSearchEngine::UserSearchEngine() 
-    : usersByID([](const int& a, const int& b) { return a < b; }),
-      usersByName([](const string& a, const string& b) { return a < b; }) {
+// Smallest string greater than every string starting with prefix ("" if there is none)
+static string prefixUpperBound(const string& prefix) {
+    string upper = prefix;
+    while (!upper.empty() && static_cast<unsigned char>(upper.back()) == 0xFF) {
+        upper.pop_back();
+    }
+    if (!upper.empty()) {
+        upper.back() = static_cast<char>(static_cast<unsigned char>(upper.back()) + 1);
+    }
+    return upper;
+}
+
+template<typename Key>
+static vector<User*> usersOf(const vector<pair<Key, User*>>& entries) {
+    vector<User*> users;
+    users.reserve(entries.size());
+    for (const auto& entry : entries) {
+        users.push_back(entry.second);
+    }
+    return users;
+}
+
+UserSearchEngine::UserSearchEngine(IndexBackend indexBackend)
+    : backend(indexBackend),
+      usersByID([](const int& a, const int& b) { return a < b; }),
+      usersByName([](const string& a, const string& b) { return a < b; }),
+      writerSnapshot(make_shared<const UserSnapshot>()) {
+    publishedSnapshot.store(writerSnapshot.get());
 }
 
 UserSearchEngine::~UserSearchEngine() {
 }
 
 void UserSearchEngine::migrateFromLinkedList(const LinkedList<User>& userList) {
+    for (auto* node = userList.head(); node; node = node->next) {
+        addUser(&node->data);
+    }
 }
 
 bool UserSearchEngine::addUser(User* user) {
+    if (!user) {
+        return false;
+    }
+    if (backend == SNAPSHOT_AVL_INDEX) {
+        lock_guard<mutex> lock(writerMutex);
+        if (writerSnapshot->byID.find(user->userID) || writerSnapshot->byName.find(user->userName)) {
+            return false;
+        }
+        publishSnapshot(make_shared<const UserSnapshot>(UserSnapshot{
+            writerSnapshot->byID.insert(user->userID, user),
+            writerSnapshot->byName.insert(user->userName, user),
+            writerSnapshot->nameTrigrams.insert(user->userName, user),
+            writerSnapshot->nameBKTree.insert(user->userName, user)}));
+        return true;
+    }
+    if (searchByID(user->userID) || searchByUsername(user->userName)) {
+        return false;
+    }
+    if (backend == BPLUS_TREE_INDEX) {
+        bplusByID.insert(user->userID, user);
+        bplusByName.insert(user->userName, user);
+    } else {
+        usersByID.insert(user->userID, user);
+        usersByName.insert(user->userName, user);
+    }
+    usernameTrie.insert(user->userName, user);
+    usernameBKTree.insert(user->userName, user);
+    usernameTrigrams.insert(user->userName, user);
+    return true;
 }
 
 bool UserSearchEngine::removeUser(int userID) {
+    if (backend == SNAPSHOT_AVL_INDEX) {
+        lock_guard<mutex> lock(writerMutex);
+        User* const* user = writerSnapshot->byID.find(userID);
+        if (!user) {
+            return false;
+        }
+        removeFromIndices(*user);
+        return true;
+    }
+    User* user = searchByID(userID);
+    if (!user) {
+        return false;
+    }
+    removeFromIndices(user);
+    return true;
 }
 
 bool UserSearchEngine::removeUser(const string& username) {
+    if (backend == SNAPSHOT_AVL_INDEX) {
+        lock_guard<mutex> lock(writerMutex);
+        User* const* user = writerSnapshot->byName.find(username);
+        if (!user) {
+            return false;
+        }
+        removeFromIndices(*user);
+        return true;
+    }
+    User* user = searchByUsername(username);
+    if (!user) {
+        return false;
+    }
+    removeFromIndices(user);
+    return true;
+}
+
+void UserSearchEngine::removeFromIndices(User* user) {
+    if (backend == SNAPSHOT_AVL_INDEX) {
+        publishSnapshot(make_shared<const UserSnapshot>(UserSnapshot{
+            writerSnapshot->byID.remove(user->userID),
+            writerSnapshot->byName.remove(user->userName),
+            writerSnapshot->nameTrigrams.remove(user->userName),
+            writerSnapshot->nameBKTree.remove(user->userName)}));
+        return;
+    }
+    if (backend == BPLUS_TREE_INDEX) {
+        bplusByID.remove(user->userID);
+        bplusByName.remove(user->userName);
+    } else {
+        usersByID.remove(user->userID);
+        usersByName.remove(user->userName);
+    }
+    usernameTrie.remove(user->userName);
+    usernameBKTree.remove(user->userName);
+    usernameTrigrams.remove(user->userName);
+}
+
+void UserSearchEngine::publishSnapshot(shared_ptr<const UserSnapshot> next) {
+    shared_ptr<const UserSnapshot> previous = writerSnapshot;
+    writerSnapshot = move(next);
+    publishedSnapshot.store(writerSnapshot.get());
+    // Readers may still be walking the old version; the reclaimer frees it once they have left
+    reclaimer.retire(move(previous));
+    reclaimer.reclaim();
 }
 
 User* UserSearchEngine::searchByID(int userID) const {
+    if (backend == SNAPSHOT_AVL_INDEX) {
+        EpochReclaimer::ReadGuard guard(reclaimer);
+        User* const* user = publishedSnapshot.load()->byID.find(userID);
+        return user ? *user : nullptr;
+    }
+    User* const* user = backend == BPLUS_TREE_INDEX ? bplusByID.find(userID) : usersByID.find(userID);
+    return user ? *user : nullptr;
 }
 
 User* UserSearchEngine::searchByUsername(const std::string& username) const {
+    if (backend == SNAPSHOT_AVL_INDEX) {
+        EpochReclaimer::ReadGuard guard(reclaimer);
+        User* const* user = publishedSnapshot.load()->byName.find(username);
+        return user ? *user : nullptr;
+    }
+    User* const* user = backend == BPLUS_TREE_INDEX ? bplusByName.find(username) : usersByName.find(username);
+    return user ? *user : nullptr;
 }
 
-std::vector<User*> UserSearchEngine::searchByUsernamePrefix(const string& prefix) const {
+std::vector<User*> UserSearchEngine::searchByUsernamePrefix(const string& prefix, size_t limit) const {
+    vector<User*> results;
+    if (backend == SNAPSHOT_AVL_INDEX) {
+        // The trie is not shared with readers here; use the rank interval of the snapshot instead
+        EpochReclaimer::ReadGuard guard(reclaimer);
+        const PersistentAVL<string, User*>& byName = publishedSnapshot.load()->byName;
+        size_t first = byName.rank(prefix);
+        string upper = prefixUpperBound(prefix);
+        size_t count = (upper.empty() ? byName.size() : byName.rank(upper)) - first;
+        return usersOf(byName.selectRange(first, limit == 0 ? count : min(count, limit)));
+    }
+    usernameTrie.collectPrefix(prefix, limit, results);
+    return results;
+}
+
+vector<User*> UserSearchEngine::searchByUsernameSubstring(const string& fragment, size_t limit) const {
+    vector<pair<string, User*>> matches;
+    if (backend == SNAPSHOT_AVL_INDEX) {
+        // The snapshot's trigram index yields matches in name order, so the limit ends the walk
+        EpochReclaimer::ReadGuard guard(reclaimer);
+        publishedSnapshot.load()->nameTrigrams.search(fragment, matches, limit);
+        return usersOf(matches);
+    }
+    usernameTrigrams.search(fragment, matches);
+    size_t count = limit == 0 ? matches.size() : min(limit, matches.size());
+    partial_sort(matches.begin(), matches.begin() + count, matches.end(),
+                 [](const pair<string, User*>& a, const pair<string, User*>& b) { return a.first < b.first; });
+    matches.resize(count);
+    return usersOf(matches);
 }
 
 std::vector<User*> UserSearchEngine::getUsersInIDRange(int minID, int maxID) const {
+    if (backend == SNAPSHOT_AVL_INDEX) {
+        EpochReclaimer::ReadGuard guard(reclaimer);
+        return usersOf(publishedSnapshot.load()->byID.findRange(minID, maxID));
+    }
+    if (backend == BPLUS_TREE_INDEX) {
+        return usersOf(bplusByID.findRange(minID, maxID));
+    }
+    return usersOf(usersByID.findRange(minID, maxID));
+}
+
+size_t UserSearchEngine::countUsersInIDRange(int minID, int maxID) const {
+    if (backend == SNAPSHOT_AVL_INDEX) {
+        EpochReclaimer::ReadGuard guard(reclaimer);
+        return publishedSnapshot.load()->byID.countRange(minID, maxID);
+    }
+    if (backend == BPLUS_TREE_INDEX) {
+        return bplusByID.countRange(minID, maxID);
+    }
+    return usersByID.countRange(minID, maxID);
+}
+
+vector<User*> UserSearchEngine::getUsersPage(size_t pageIndex, size_t pageSize, bool byID) const {
+    if (pageSize == 0 || pageIndex > getTotalUsers() / pageSize) {
+        return {};
+    }
+    size_t first = pageIndex * pageSize;
+    if (backend == SNAPSHOT_AVL_INDEX) {
+        EpochReclaimer::ReadGuard guard(reclaimer);
+        const UserSnapshot* snapshot = publishedSnapshot.load();
+        return byID ? usersOf(snapshot->byID.selectRange(first, pageSize)) : usersOf(snapshot->byName.selectRange(first, pageSize));
+    }
+    if (backend == BPLUS_TREE_INDEX) {
+        return byID ? usersOf(bplusByID.selectRange(first, pageSize)) : usersOf(bplusByName.selectRange(first, pageSize));
+    }
+    return byID ? usersOf(usersByID.selectRange(first, pageSize)) : usersOf(usersByName.selectRange(first, pageSize));
 }
 
 std::vector<User*> UserSearchEngine::fuzzyUsernameSearch(const string& username, int maxEditDistance) const {
+    vector<User*> results;
+    if (maxEditDistance < 0) {
+        return results;
+    }
+    vector<pair<int, User*>> matches;
+    if (backend == SNAPSHOT_AVL_INDEX) {
+        EpochReclaimer::ReadGuard guard(reclaimer);
+        publishedSnapshot.load()->nameBKTree.search(username, maxEditDistance, matches);
+    } else {
+        usernameBKTree.search(username, maxEditDistance, matches);
+    }
+    results.reserve(matches.size());
+    for (const auto& match : matches) {
+        results.push_back(match.second);
+    }
+    sort(results.begin(), results.end(), [](const User* a, const User* b) { return a->userName < b->userName; });
+    return results;
 }
 
 int UserSearchEngine::calculateEditDistance(const string& str1, const string& str2) const {
+    return LevenshteinMatcher(str1).distance(str2);
+}
+
+void UserSearchEngine::collectPrefixMatches(const AVLTree<string, User*>& tree, const string& prefix, vector<User*>& results) const {
+    // Matches form one contiguous rank interval [rank(prefix), rank(upper))
+    size_t first = tree.rank(prefix);
+    string upper = prefixUpperBound(prefix);
+    size_t last = upper.empty() ? tree.size() : tree.rank(upper);
+    vector<User*> matches = usersOf(tree.selectRange(first, last - first));
+    results.insert(results.end(), matches.begin(), matches.end());
 }
 
 vector<User*> UserSearchEngine::getAllUsersSorted(bool byID) const {
+    if (backend == SNAPSHOT_AVL_INDEX) {
+        EpochReclaimer::ReadGuard guard(reclaimer);
+        const UserSnapshot* snapshot = publishedSnapshot.load();
+        return byID ? usersOf(snapshot->byID.inOrderTraversal()) : usersOf(snapshot->byName.inOrderTraversal());
+    }
+    if (backend == BPLUS_TREE_INDEX) {
+        return byID ? usersOf(bplusByID.inOrderTraversal()) : usersOf(bplusByName.inOrderTraversal());
+    }
+    return byID ? usersOf(usersByID.inOrderTraversal()) : usersOf(usersByName.inOrderTraversal());
 }
 
 size_t UserSearchEngine::getTotalUsers() const {
+    if (backend == SNAPSHOT_AVL_INDEX) {
+        EpochReclaimer::ReadGuard guard(reclaimer);
+        return publishedSnapshot.load()->byID.size();
+    }
+    return backend == BPLUS_TREE_INDEX ? bplusByID.size() : usersByID.size();
 }
 
 void UserSearchEngine::displaySearchStats() const {
+    cout << "User Search Engine Statistics" << endl;
+    cout << "  Total users      : " << getTotalUsers() << endl;
+    if (backend == SNAPSHOT_AVL_INDEX) {
+        EpochReclaimer::ReadGuard guard(reclaimer);
+        const UserSnapshot* snapshot = publishedSnapshot.load();
+        cout << "  Index backend    : snapshot AVL tree (" << reclaimer.pendingCount()
+             << " retired versions pending)" << endl;
+        cout << "  ID index height  : " << snapshot->byID.getTreeHeight() << endl;
+        cout << "  Name index height: " << snapshot->byName.getTreeHeight() << endl;
+        cout << "  Name trigrams    : " << snapshot->nameTrigrams.trigramCount() << endl;
+    } else if (backend == BPLUS_TREE_INDEX) {
+        cout << "  Index backend    : B+ tree (fanout " << bplusByID.getFanout()
+             << " by ID, " << bplusByName.getFanout() << " by name)" << endl;
+        cout << "  ID index height  : " << bplusByID.getTreeHeight() << endl;
+        cout << "  Name index height: " << bplusByName.getTreeHeight() << endl;
+    } else {
+        cout << "  Index backend    : AVL tree" << endl;
+        cout << "  ID index height  : " << usersByID.getTreeHeight()
+             << " (avg depth " << usersByID.getAverageDepth() << ")" << endl;
+        cout << "  Name index height: " << usersByName.getTreeHeight()
+             << " (avg depth " << usersByName.getAverageDepth() << ")" << endl;
+    }
+    if (backend != SNAPSHOT_AVL_INDEX) {
+        cout << "  Name trigrams    : " << usernameTrigrams.trigramCount() << endl;
+    }
+    cout << "  Indices consistent: " << (isConsistent() ? "yes" : "no") << endl;
 }
 
 bool UserSearchEngine::isConsistent() const {
-}
\ No newline at end of file
+    if (backend == SNAPSHOT_AVL_INDEX) {
+        // Check a single version so a concurrent writer cannot cause a false alarm
+        EpochReclaimer::ReadGuard guard(reclaimer);
+        const UserSnapshot* snapshot = publishedSnapshot.load();
+        size_t nameCount = snapshot->byName.size();
+        if (snapshot->byID.size() != nameCount || snapshot->nameTrigrams.size() != nameCount ||
+            snapshot->nameBKTree.size() != nameCount ||
+            !snapshot->byID.isValidAVL() || !snapshot->byName.isValidAVL()) {
+            return false;
+        }
+        for (const auto& entry : snapshot->byID.inOrderTraversal()) {
+            User* const* named = snapshot->byName.find(entry.second->userName);
+            User* const* fuzzyEntry = snapshot->nameBKTree.find(entry.second->userName);
+            if (!named || *named != entry.second || !fuzzyEntry || *fuzzyEntry != entry.second) {
+                return false;
+            }
+        }
+        return true;
+    }
+    size_t nameCount = backend == BPLUS_TREE_INDEX ? bplusByName.size() : usersByName.size();
+    if (getTotalUsers() != nameCount || usernameTrie.size() != nameCount ||
+        usernameBKTree.size() != nameCount || usernameTrigrams.size() != nameCount) {
+        return false;
+    }
+    for (User* user : getAllUsersSorted(true)) {
+        if (!user || searchByID(user->userID) != user || searchByUsername(user->userName) != user) {
+            return false;
+        }
+        User* const* trieEntry = usernameTrie.find(user->userName);
+        User* const* trigramEntry = usernameTrigrams.find(user->userName);
+        if (!trieEntry || *trieEntry != user || !trigramEntry || *trigramEntry != user) {
+            return false;
+        }
+    }
+    return true;
+}
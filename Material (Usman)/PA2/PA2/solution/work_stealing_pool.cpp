@@ -0,0 +1,104 @@
+#include "../headers/work_stealing_pool.h"
+#include <algorithm>
+#include <cassert>
+using namespace std;
+
+// Lets submit() called from inside a task push onto the calling worker's own deque
+static thread_local const WorkStealingPool* currentPool = nullptr;
+static thread_local size_t currentWorker = 0;
+
+WorkStealingPool::WorkStealingPool(size_t threads)
+    : pending(0), queued(0), idle(0), nextQueue(0), steals(0), stopping(false) {
+    if (threads == 0) {
+        threads = max(1u, thread::hardware_concurrency());
+    }
+    for (size_t i = 0; i < threads; ++i) {
+        queues.emplace_back(new WorkQueue());
+    }
+    for (size_t i = 0; i < threads; ++i) {
+        workers.emplace_back(&WorkStealingPool::workerLoop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    wait();
+    {
+        lock_guard<mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void WorkStealingPool::submit(function<void()> task) {
+    pending++;
+    size_t target = currentPool == this ? currentWorker : nextQueue++ % queues.size();
+    {
+        lock_guard<mutex> lock(queues[target]->lock);
+        queues[target]->tasks.push_back(move(task));
+    }
+    queued++;
+    // A sleeper bumps idle before re-checking queued, so one of the two sides always sees the other
+    if (idle.load() > 0) {
+        {
+            lock_guard<mutex> lock(sleepMutex);
+        }
+        workAvailable.notify_one();
+    }
+}
+
+void WorkStealingPool::wait() {
+    assert(currentPool != this && "WorkStealingPool::wait() called from one of its own workers");
+    unique_lock<mutex> lock(sleepMutex);
+    allDone.wait(lock, [this]() { return pending.load() == 0; });
+}
+
+bool WorkStealingPool::runOne(size_t index) {
+    function<void()> task;
+    {
+        WorkQueue& own = *queues[index];
+        lock_guard<mutex> lock(own.lock);
+        if (!own.tasks.empty()) {
+            task = move(own.tasks.back());
+            own.tasks.pop_back();
+        }
+    }
+    for (size_t i = 1; !task && i < queues.size(); ++i) {
+        WorkQueue& victim = *queues[(index + i) % queues.size()];
+        lock_guard<mutex> lock(victim.lock);
+        if (!victim.tasks.empty()) {
+            task = move(victim.tasks.front());
+            victim.tasks.pop_front();
+            steals++;
+        }
+    }
+    if (!task) {
+        return false;
+    }
+    queued--;
+    task();
+    if (--pending == 0) {
+        lock_guard<mutex> lock(sleepMutex);
+        allDone.notify_all();
+    }
+    return true;
+}
+
+void WorkStealingPool::workerLoop(size_t index) {
+    currentPool = this;
+    currentWorker = index;
+    while (true) {
+        if (runOne(index)) {
+            continue;
+        }
+        unique_lock<mutex> lock(sleepMutex);
+        idle++;
+        workAvailable.wait(lock, [this]() { return stopping.load() || queued.load() > 0; });
+        idle--;
+        if (stopping && queued.load() == 0) {
+            return;
+        }
+    }
+}
@@ -1,22 +1,37 @@
 #include <iostream>
 #include <cstdlib>
+#include <cstring>
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
 using namespace std;
 
 // Adjust compiler + flags to match your Makefile
 const string CXX = "g++";
-const string CXXFLAGS = "-std=c++17 -Wall -g -Iheaders -Isolution";
+const string CXXFLAGS_BASE = "-std=c++17 -Wall -pthread -Iheaders -Isolution";
+const string CXXFLAGS = CXXFLAGS_BASE + " -g";
 const string SOLUTION_SRCS =
     "solution/category_tree.cpp "
+    "solution/epoch_reclaimer.cpp "
     "solution/follow_list.cpp "
+    "solution/levenshtein.cpp "
     "solution/linked_list.cpp "
     "solution/post_list.cpp "
     "solution/post_pool.cpp "
     "solution/user.cpp "
     "solution/user_manager.cpp "
-    "solution/user_search_engine.cpp";
+    "solution/user_search_engine.cpp "
+    "solution/work_stealing_pool.cpp";
 const string TESTS_DIR = "tests/";
 
 // Structure for one test entry
@@ -35,9 +50,260 @@ vector<TestEntry> tests = {
     {1, "BST Tester", "bst_test.cpp", "tests/bst_tester_exe", 20},
     {2, "AVL Tester", "avl_test.cpp", "tests/avl_tester_exe", 25},
     {3, "Category Tree Tester", "category_tree_test.cpp", "tests/category_tree_test_exe", 30},
-    {4, "User Search Engine Tester", "user_search_engine_test.cpp", "tests/user_search_engine_tester_exe", 25}
+    {4, "User Search Engine Tester", "user_search_engine_test.cpp", "tests/user_search_engine_tester_exe", 25},
+    {5, "B+ Tree Tester (extension)", "bplus_tree_test.cpp", "tests/bplus_tree_tester_exe", 0},
+    {6, "Category Tree Tester (extensions)", "category_tree_ext_test.cpp", "tests/category_tree_ext_tester_exe", 0},
+    {7, "User Search Engine Tester (extensions)", "user_search_engine_ext_test.cpp", "tests/user_search_engine_ext_tester_exe", 0}
 };
 
+// Every suite is built once per configuration by the batch runner (--all)
+struct BuildConfig
+{
+    string name;
+    string flags;
+    string exeSuffix;
+};
+
+const vector<BuildConfig> BUILD_CONFIGS = {
+    {"debug", "-g", ""},
+    {"release", "-O2", "_O2"}
+};
+
+const int MENU_RUN_ALL = 9;
+const string DEFAULT_REPORT = "tests/timing_report.json";
+
+struct ProcessResult
+{
+    int exitCode = -1;     // -1 if killed by a signal
+    bool timedOut = false;
+    double seconds = 0.0;  // wall clock
+    long peakRssKb = 0;    // largest RSS of the process or any descendant it waited for
+};
+
+// Runs cmd through /bin/sh with stdout/stderr sent to logFile. A timeout of 0 waits forever;
+// otherwise the whole process group is killed once the deadline passes.
+ProcessResult run_process(const string &cmd, const string &logFile, double timeoutSeconds)
+{
+    ProcessResult result;
+    auto start = chrono::steady_clock::now();
+    // Only async-signal-safe calls are allowed in the child of a multithreaded fork
+    pid_t pid = fork();
+    if (pid < 0)
+        return result;
+    if (pid == 0)
+    {
+        setpgid(0, 0);
+        int out = open(logFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        int in = open("/dev/null", O_RDONLY);
+        if (out >= 0)
+        {
+            dup2(out, STDOUT_FILENO);
+            dup2(out, STDERR_FILENO);
+        }
+        if (in >= 0)
+            dup2(in, STDIN_FILENO);
+        execl("/bin/sh", "sh", "-c", cmd.c_str(), (char *)nullptr);
+        _exit(127);
+    }
+    setpgid(pid, pid); // also done by the child; whichever runs first wins the race
+
+    int status = 0;
+    struct rusage usage;
+    memset(&usage, 0, sizeof(usage));
+    while (true)
+    {
+        pid_t done = wait4(pid, &status, WNOHANG, &usage);
+        if (done == pid || done < 0)
+            break;
+        double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        if (timeoutSeconds > 0 && elapsed > timeoutSeconds)
+        {
+            kill(-pid, SIGKILL);
+            wait4(pid, &status, 0, &usage);
+            result.timedOut = true;
+            break;
+        }
+        this_thread::sleep_for(chrono::milliseconds(5));
+    }
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+#ifdef __APPLE__
+    result.peakRssKb = usage.ru_maxrss / 1024; // macOS reports bytes
+#else
+    result.peakRssKb = usage.ru_maxrss; // Linux reports kilobytes
+#endif
+    if (WIFEXITED(status) && !result.timedOut)
+        result.exitCode = WEXITSTATUS(status);
+    return result;
+}
+
+// Runs job(0) .. job(count - 1) on up to maxParallel threads
+template <typename Job>
+void run_parallel(size_t count, size_t maxParallel, Job job)
+{
+    atomic<size_t> next(0);
+    vector<thread> threads;
+    for (size_t t = 0; t < min(count, maxParallel); ++t)
+        threads.emplace_back([&]()
+        {
+            for (size_t i = next++; i < count; i = next++)
+                job(i);
+        });
+    for (thread &th : threads)
+        th.join();
+}
+
+// One suite built in one configuration
+struct BatchJob
+{
+    const TestEntry *test;
+    const BuildConfig *config;
+    string exeFile;
+    ProcessResult compile;
+    ProcessResult run;
+    bool ran = false;
+    int score = -1;
+    int maxScore = -1;
+};
+
+// Pulls "FINAL SCORE: x / y" out of a suite's log
+void parse_score(const string &logFile, BatchJob &job)
+{
+    ifstream in(logFile);
+    string line;
+    while (getline(in, line))
+    {
+        size_t pos = line.find("FINAL SCORE:");
+        if (pos == string::npos)
+            continue;
+        char slash = 0;
+        istringstream fields(line.substr(pos + strlen("FINAL SCORE:")));
+        int score, maxScore;
+        if (fields >> score >> slash >> maxScore && slash == '/')
+        {
+            job.score = score;
+            job.maxScore = maxScore;
+        }
+    }
+}
+
+string json_escape(const string &text)
+{
+    string out;
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+            out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+void write_process_json(ostream &out, const char *key, const ProcessResult &p, bool last)
+{
+    out << "      \"" << key << "\": {\"exit_code\": " << p.exitCode
+        << ", \"timed_out\": " << (p.timedOut ? "true" : "false")
+        << ", \"seconds\": " << p.seconds
+        << ", \"peak_rss_kb\": " << p.peakRssKb << "}" << (last ? "" : ",") << "\n";
+}
+
+void write_report(ostream &out, const vector<BatchJob> &jobs, size_t parallelism, double timeoutSeconds)
+{
+    out << "{\n";
+    out << "  \"compiler\": \"" << json_escape(CXX) << "\",\n";
+    out << "  \"parallelism\": " << parallelism << ",\n";
+    out << "  \"timeout_seconds\": " << timeoutSeconds << ",\n";
+    out << "  \"suites\": [\n";
+    for (size_t i = 0; i < jobs.size(); ++i)
+    {
+        const BatchJob &job = jobs[i];
+        out << "    {\n";
+        out << "      \"name\": \"" << json_escape(job.test->name) << "\",\n";
+        out << "      \"config\": \"" << job.config->name << "\",\n";
+        out << "      \"flags\": \"" << json_escape(job.config->flags) << "\",\n";
+        out << "      \"score\": " << job.score << ",\n";
+        out << "      \"max_score\": " << job.maxScore << ",\n";
+        write_process_json(out, "compile", job.compile, !job.ran);
+        if (job.ran)
+            write_process_json(out, "run", job.run, true);
+        out << "    }" << (i + 1 == jobs.size() ? "" : ",") << "\n";
+    }
+    out << "  ]\n";
+    out << "}\n";
+}
+
+// Builds every suite in every configuration in parallel, then runs the binaries concurrently.
+// Suite output goes to <exe>.compile.log / <exe>.run.log; the summary goes to reportFile.
+// Returns true if everything compiled, finished in time and scored full marks.
+bool run_all_parallel(size_t parallelism, double timeoutSeconds, const string &reportFile)
+{
+    vector<BatchJob> jobs;
+    for (const auto &t : tests)
+        for (const auto &config : BUILD_CONFIGS)
+        {
+            BatchJob job;
+            job.test = &t;
+            job.config = &config;
+            job.exeFile = t.exeFile + config.exeSuffix;
+            jobs.push_back(job);
+        }
+
+    cout << "\n>>> Compiling " << jobs.size() << " builds with up to " << parallelism << " in parallel ..." << endl;
+    run_parallel(jobs.size(), parallelism, [&](size_t i)
+    {
+        BatchJob &job = jobs[i];
+        string compileCmd = "exec " + CXX + " " + CXXFLAGS_BASE + " " + job.config->flags +
+                            " " + SOLUTION_SRCS +
+                            " " + TESTS_DIR + job.test->sourceFile +
+                            " -o " + job.exeFile;
+        job.compile = run_process(compileCmd, job.exeFile + ".compile.log", 0);
+    });
+
+    cout << ">>> Running suites (timeout " << timeoutSeconds << "s each) ..." << endl;
+    run_parallel(jobs.size(), parallelism, [&](size_t i)
+    {
+        BatchJob &job = jobs[i];
+        if (job.compile.exitCode != 0)
+            return;
+        string logFile = job.exeFile + ".run.log";
+        job.run = run_process("exec ./" + job.exeFile, logFile, timeoutSeconds);
+        job.ran = true;
+        parse_score(logFile, job);
+    });
+
+    bool allPassed = true;
+    cout << "\n======================================================" << endl;
+    for (const auto &job : jobs)
+    {
+        string status;
+        if (job.compile.exitCode != 0)
+            status = "COMPILE FAILED";
+        else if (job.run.timedOut)
+            status = "TIMED OUT";
+        else if (job.run.exitCode != 0)
+            status = "CRASHED";
+        else if (job.score < 0)
+            status = "NO SCORE";
+        else
+            status = to_string(job.score) + " / " + to_string(job.maxScore);
+        bool passed = job.ran && !job.run.timedOut && job.run.exitCode == 0 && job.score >= 0 && job.score == job.maxScore;
+        allPassed = allPassed && passed;
+        cout << "  " << job.test->name << " [" << job.config->name << "]: " << status
+             << "  (compile " << job.compile.seconds << "s, run " << job.run.seconds
+             << "s, peak " << job.run.peakRssKb << " KB)" << endl;
+    }
+    cout << "======================================================" << endl;
+
+    ofstream report(reportFile);
+    if (!report)
+    {
+        cout << "[ERROR] Could not write timing report to " << reportFile << endl;
+        return false;
+    }
+    write_report(report, jobs, parallelism, timeoutSeconds);
+    cout << "Timing report written to " << reportFile << endl;
+    return allPassed;
+}
+
 void print_menu()
 {
     cout << "======================================================" << endl;
@@ -46,10 +312,13 @@ void print_menu()
     cout << "\n  Available Tests (Total: 100 points):\n" << endl;
     for (const auto &t : tests)
     {
-        cout << "  " << t.id << ". " << t.name 
-             << " (" << t.points << " points)" << endl;
+        cout << "  " << t.id << ". " << t.name;
+        if (t.points > 0)
+            cout << " (" << t.points << " points)";
+        cout << endl;
     }
-    cout << "\n  0. Exit" << endl;
+    cout << "\n  " << MENU_RUN_ALL << ". Build & run all in parallel (debug + -O2, timing report)" << endl;
+    cout << "  0. Exit" << endl;
     cout << "======================================================" << endl;
     cout << "Select a test to compile and run: ";
 }
@@ -81,8 +350,44 @@ void print_scoring_breakdown()
     cout << "======================================================\n" << endl;
 }
 
-int main()
+void print_usage(const char *argv0)
 {
+    cout << "Usage: " << argv0 << " [--all] [--jobs N] [--timeout SECONDS] [--report FILE]" << endl;
+    cout << "  With no arguments the interactive menu is shown." << endl;
+    cout << "  --all      build every suite (debug and -O2) in parallel, run them concurrently and" << endl;
+    cout << "             write a JSON timing report; exits non-zero unless every suite scores full marks" << endl;
+    cout << "  --jobs     maximum builds/runs at once (default: hardware threads)" << endl;
+    cout << "  --timeout  per-suite run timeout in seconds, 0 for none (default: 120)" << endl;
+    cout << "  --report   report path (default: " << DEFAULT_REPORT << ")" << endl;
+}
+
+int main(int argc, char **argv)
+{
+    size_t parallelism = max(1u, thread::hardware_concurrency());
+    double timeoutSeconds = 120;
+    string reportFile = DEFAULT_REPORT;
+    bool batch = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--all")
+            batch = true;
+        else if (arg == "--jobs" && hasValue)
+            parallelism = max(1, atoi(argv[++i]));
+        else if (arg == "--timeout" && hasValue)
+            timeoutSeconds = atof(argv[++i]);
+        else if (arg == "--report" && hasValue)
+            reportFile = argv[++i];
+        else
+        {
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+    if (batch)
+        return run_all_parallel(parallelism, timeoutSeconds, reportFile) ? 0 : 1;
+
     print_scoring_breakdown();
     
     while (true)
@@ -104,6 +409,13 @@ int main()
             break;
         }
 
+        if (choice == MENU_RUN_ALL)
+        {
+            run_all_parallel(parallelism, timeoutSeconds, reportFile);
+            cout << endl;
+            continue;
+        }
+
         // Find the selected test
         auto it = find_if(tests.begin(), tests.end(),
                           [&](const TestEntry &t)
@@ -0,0 +1,210 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <functional>
+#include <algorithm>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <map>
+#include <set>
+
+#include "bplus_tree.h"
+
+using namespace std;
+
+class TestRunner {
+public:
+    TestRunner() : total_score(0), max_score(0) {}
+
+    void run_all_tests() {
+        cout << "=======================================================================" << endl;
+        cout << "                 B+ Tree Implementation Tester" << endl;
+        cout << "=======================================================================" << endl;
+
+        test_structure();
+        test_queries();
+        test_randomized();
+
+        cout << "\n-----------------------------------------------------------------------" << endl;
+        cout << "                           TESTING SUMMARY" << endl;
+        cout << "-----------------------------------------------------------------------" << endl;
+        cout << "  FINAL SCORE: " << total_score << " / " << max_score << endl;
+        if (total_score == max_score) {
+            cout << "  RESULT: All tests passed!" << endl;
+        } else {
+            cout << "  RESULT: Some tests failed." << endl;
+        }
+        cout << "=======================================================================" << endl;
+    }
+
+private:
+    int total_score;
+    int max_score;
+
+    void execute_test(const string& name, int points, const string& desc, const function<bool()>& test_func) {
+        max_score += points;
+        cout << "\n  - " << name << " [" << points << " pts]" << endl;
+        cout << "    " << desc << endl;
+        cout << "    Running test... ";
+        if (test_func()) {
+            cout << "PASSED" << endl;
+            total_score += points;
+        } else {
+            cout << "FAILED" << endl;
+        }
+    }
+
+    static bool matches(const BPlusTree<int, int>& tree, const map<int, int>& expected) {
+        if (!tree.isValidBPlusTree() || tree.size() != expected.size()) return false;
+        vector<pair<int, int>> actual = tree.inOrderTraversal();
+        return actual == vector<pair<int, int>>(expected.begin(), expected.end());
+    }
+
+    void test_structure() {
+        cout << "\n--- Part 1: Splits, Borrows and Merges ---" << endl;
+
+        execute_test("Ascending Inserts Split Leaves", 10, "Inserting 1..100 with fanout 4.", []() {
+            BPlusTree<int, int> tree(4);
+            map<int, int> expected;
+            for (int i = 1; i <= 100; ++i) {
+                if (!tree.insert(i, i * 10)) return false;
+                expected[i] = i * 10;
+                if (!tree.isValidBPlusTree()) return false;
+            }
+            return matches(tree, expected) && tree.getTreeHeight() > 2;
+        });
+
+        execute_test("Duplicate Keys Are Ignored", 5, "Inserting {5, 3, 5}; the first value is kept.", []() {
+            BPlusTree<int, int> tree(4);
+            tree.insert(5, 1);
+            tree.insert(3, 2);
+            bool duplicate = tree.insert(5, 99);
+            return !duplicate && tree.size() == 2 && *tree.find(5) == 1;
+        });
+
+        execute_test("Removals Collapse the Root", 10, "Inserting 1..64 then removing every key.", []() {
+            BPlusTree<int, int> tree(4);
+            map<int, int> expected;
+            for (int i = 1; i <= 64; ++i) { tree.insert(i, i); expected[i] = i; }
+            for (int i = 64; i >= 1; i -= 2) {
+                if (!tree.remove(i)) return false;
+                expected.erase(i);
+                if (!matches(tree, expected)) return false;
+            }
+            for (int i = 1; i <= 64; i += 2) {
+                if (!tree.remove(i)) return false;
+                expected.erase(i);
+                if (!matches(tree, expected)) return false;
+            }
+            return tree.empty() && tree.getTreeHeight() == 0 && !tree.remove(1);
+        });
+    }
+
+    void test_queries() {
+        cout << "\n--- Part 2: Lookups and Range Scans ---" << endl;
+        BPlusTree<int, int> tree(8);
+        for (int i = 0; i < 200; ++i) tree.insert(i * 5, i);
+
+        execute_test("Point Lookups", 5, "find() hits every inserted key and misses the gaps.", [&]() {
+            for (int i = 0; i < 200; ++i) {
+                const int* value = tree.find(i * 5);
+                if (!value || *value != i || tree.find(i * 5 + 1)) return false;
+            }
+            return tree.min().first == 0 && tree.max().first == 995;
+        });
+
+        execute_test("findRange Walks Linked Leaves", 10, "Ranges [12, 48], [-10, 3], [990, 2000] and [50, 40].", [&]() {
+            auto middle = tree.findRange(12, 48);
+            if (middle.size() != 7 || middle.front().first != 15 || middle.back().first != 45) return false;
+            if (tree.findRange(-10, 3).size() != 1 || tree.findRange(990, 2000).size() != 2) return false;
+            return tree.findRange(50, 40).empty();
+        });
+
+        execute_test("countRange and selectRange", 10, "Counting and paging without materialising the whole tree.", [&]() {
+            if (tree.countRange(12, 48) != 7 || tree.countRange(0, 995) != 200 || tree.countRange(50, 40) != 0) return false;
+            auto page = tree.selectRange(37, 5);
+            if (page.size() != 5 || page.front().first != 185 || page.back().first != 205) return false;
+            return tree.selectRange(198, 10).size() == 2 && tree.selectRange(200, 1).empty();
+        });
+
+        execute_test("Empty Tree Edge Cases", 5, "min()/max() throw and scans return nothing.", []() {
+            BPlusTree<string, string> empty_tree;
+            try { empty_tree.min(); return false; } catch (const std::exception&) {}
+            try { empty_tree.max(); return false; } catch (const std::exception&) {}
+            return empty_tree.findRange("a", "z").empty() && empty_tree.countRange("a", "z") == 0 &&
+                   empty_tree.selectRange(0, 3).empty() && empty_tree.isValidBPlusTree();
+        });
+    }
+
+    void test_randomized() {
+        cout << "\n--- Part 3: Randomized Mixed Operations ---" << endl;
+
+        execute_test("Mixed Insert/Remove Against std::map", 15, "5000 random operations at fanouts 4, 5 and the default.", []() {
+            for (size_t fanout : {size_t(4), size_t(5), BPlusTree<int, int>::defaultFanout()}) {
+                BPlusTree<int, int> tree(fanout);
+                map<int, int> expected;
+                std::mt19937 rng(2024 + fanout);
+                for (int i = 0; i < 5000; ++i) {
+                    int key = rng() % 1000;
+                    if (rng() % 3) {
+                        bool inserted = tree.insert(key, i);
+                        if (inserted != expected.insert({key, i}).second) return false;
+                    } else {
+                        if (tree.remove(key) != (expected.erase(key) == 1)) return false;
+                    }
+                    if (i % 250 == 0 && !matches(tree, expected)) return false;
+                }
+                if (!matches(tree, expected)) return false;
+            }
+            return true;
+        });
+
+        execute_test("Subtree Counts Through Splits and Merges", 10, "countRange/selectRange against std::map while fanout-4 nodes split, borrow and merge.", []() {
+            BPlusTree<int, int> tree(4);
+            map<int, int> expected;
+            std::mt19937 rng(77);
+            for (int i = 0; i < 4000; ++i) {
+                int key = rng() % 600;
+                if (rng() % 2) {
+                    tree.insert(key, i);
+                    expected.insert({key, i});
+                } else {
+                    tree.remove(key);
+                    expected.erase(key);
+                }
+                if (i % 40 != 0) continue;
+                if (!tree.isValidBPlusTree()) return false;
+                int lo = rng() % 650 - 25, hi = lo + rng() % 200;
+                size_t count = distance(expected.lower_bound(lo), expected.upper_bound(hi));
+                if (tree.countRange(lo, hi) != count) return false;
+                size_t first = expected.empty() ? 0 : rng() % expected.size();
+                auto page = tree.selectRange(first, 7);
+                auto it = expected.begin();
+                advance(it, first);
+                for (const auto& entry : page) {
+                    if (it == expected.end() || entry.first != it->first) return false;
+                    ++it;
+                }
+                if (page.size() != std::min<size_t>(7, expected.size() - first)) return false;
+            }
+            return true;
+        });
+
+        cout << "\n  Scan throughput (n = 200000, default fanout):" << endl;
+        BPlusTree<int, int> tree;
+        for (int i = 0; i < 200000; ++i) tree.insert(i, i);
+        auto start = chrono::high_resolution_clock::now();
+        size_t counted = tree.findRange(50000, 150000).size();
+        auto end = chrono::high_resolution_clock::now();
+        cout << "    findRange returned " << counted << " pairs in "
+             << fixed << setprecision(3) << chrono::duration<double, milli>(end - start).count()
+             << " ms (height " << tree.getTreeHeight() << ", fanout " << tree.getFanout() << ")" << endl;
+    }
+};
+
+int main() {
+    TestRunner runner;
+    runner.run_all_tests();
+    return 0;
+}
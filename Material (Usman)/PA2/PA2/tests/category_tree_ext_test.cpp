@@ -0,0 +1,417 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <functional>
+#include <memory>
+#include <algorithm>
+#include <iomanip>
+#include <stdexcept>
+#include <set>
+#include <map>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+// Include the header for the code being tested
+#include "category_tree.h"
+#include "post.h"
+
+using namespace std;
+
+// Checks for the path index, incremental counts, concurrent posting, compacted
+// post layout and parallel traversal extensions.
+// Ungraded: the graded behaviour lives in category_tree_test.cpp.
+class CategoryTreeTester : public CategoryTree {
+public:
+    using CategoryTree::CategoryTree;
+
+    bool verify_get_posts(const string& categoryPath, bool includeSubcategories, const vector<Post*>& expected_posts) {
+        vector<Post*> actual_posts = this->getPostsInCategory(categoryPath, includeSubcategories);
+        set<PostID> actual_ids;
+        for (const auto& post : actual_posts) actual_ids.insert(post->postID);
+        set<PostID> expected_ids;
+        for (const auto& post : expected_posts) expected_ids.insert(post->postID);
+        if (actual_ids != expected_ids || actual_posts.size() != expected_posts.size()) {
+            cout << "\n    [FAIL] The set of returned posts does not match the expected set.";
+            return false;
+        }
+        return true;
+    }
+
+    // Walks the children directly, so it does not share code with the path index.
+    shared_ptr<CategoryNode> verify_find(const string& path) {
+        if (path.empty() || path == "root") return this->root;
+
+        vector<string> categories = this->parseCategoryPath(path);
+        shared_ptr<CategoryNode> current = this->root;
+        for (const auto& cat_name : categories) {
+            shared_ptr<CategoryNode> next = nullptr;
+            if (current) {
+                for (const auto& child : current->children) {
+                    if (child->categoryName == cat_name) {
+                        next = child;
+                        break;
+                    }
+                }
+            }
+            current = next;
+        }
+        return current;
+    }
+
+    bool verify_post_counts(const vector<pair<string, int>>& expected_counts) {
+        for (const auto& p : expected_counts) {
+            shared_ptr<CategoryNode> node = verify_find(p.first);
+            if (!node) {
+                cout << "\n    [FAIL] Could not find node '" << p.first << "' to check count.";
+                return false;
+            }
+            if (node->totalPostCount != p.second) {
+                cout << "\n    [FAIL] Post count mismatch for '" << p.first << "'. Expected: " << p.second << ", Actual: " << node->totalPostCount;
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+
+class TestRunner {
+public:
+    TestRunner() : total_score(0), max_score(0) {}
+
+    void run_all_tests() {
+        cout << "=======================================================================" << endl;
+        cout << "                 Category Tree Tester (extensions)" << endl;
+        cout << "=======================================================================" << endl;
+
+        test_paths_and_index();
+        test_post_bookkeeping();
+        test_concurrency();
+        test_traversal();
+
+        cout << "\n-----------------------------------------------------------------------" << endl;
+        cout << "                           TESTING SUMMARY" << endl;
+        cout << "-----------------------------------------------------------------------" << endl;
+        cout << "  FINAL SCORE: " << total_score << " / " << max_score << endl;
+        if (total_score == max_score) {
+            cout << "  RESULT: All tests passed!" << endl;
+        } else {
+            cout << "  RESULT: Some tests failed." << endl;
+        }
+        cout << "=======================================================================" << endl;
+    }
+
+private:
+    int total_score;
+    int max_score;
+
+    void execute_test(const string& name, int points, const string& desc, const function<bool()>& test_func) {
+        max_score += points;
+        cout << "\n  - " << name << " [" << points << " pts]" << endl;
+        cout << "    " << desc << endl;
+        cout << "    Running test... ";
+        if (test_func()) {
+            cout << "PASSED" << endl;
+            total_score += points;
+        } else {
+            cout << "FAILED" << endl;
+        }
+    }
+
+    void test_paths_and_index() {
+        cout << "\n--- Part 1: Path Tokenizer and Path Index ---" << endl;
+        execute_test("PATH-1: Path Tokenizer", 5, "Segments of '', '_', 'A', '__A__BC_', 'A_B_C' are views into the path.", []() {
+            auto split = [](const string& path) {
+                vector<string_view> segments;
+                CategoryPathTokenizer tokens(path);
+                for (string_view segment; tokens.next(segment);) {
+                    if (segment.data() < path.data() || segment.data() + segment.size() > path.data() + path.size()) return vector<string_view>{"<copy>"};
+                    segments.push_back(segment);
+                }
+                return segments;
+            };
+            string a = "", b = "_", c = "A", d = "__A__BC_", e = "A_B_C";
+            return split(a).empty() && split(b).empty() && split(c) == vector<string_view>{"A"} &&
+                   split(d) == vector<string_view>{"A", "BC"} && split(e) == vector<string_view>{"A", "B", "C"};
+        });
+
+        execute_test("PATH-2: Path Index Follows Structural Changes", 10, "200 siblings, non-canonical paths, then remove and move subtrees.", []() {
+            CategoryTreeTester tree;
+            for (int i = 0; i < 200; ++i) tree.addCategory("Hub_Cat" + to_string(i) + "_Leaf");
+            for (int i = 0; i < 200; ++i) {
+                string path = "Hub_Cat" + to_string(i);
+                if (tree.findCategory(path) != tree.verify_find(path)) return false;
+                if (tree.findCategory("Hub__Cat" + to_string(i) + "_Leaf_") != tree.verify_find(path + "_Leaf")) return false;
+            }
+            if (tree.findCategory("Hub_Cat200") || tree.findCategory("Hub_Cat7_Missing")) return false;
+            for (int i = 0; i < 200; i += 2) {
+                if (!tree.removeCategory("Hub_Cat" + to_string(i))) return false;
+            }
+            if (tree.findCategory("Hub_Cat0_Leaf") || !tree.findCategory("Hub_Cat1_Leaf")) return false;
+            tree.addCategory("Other");
+            Post p1(1, "Hub_Cat1_Leaf");
+            tree.addPost(&p1);
+            if (!tree.moveCategory("Hub_Cat1", "Other")) return false;
+            return !tree.findCategory("Hub_Cat1_Leaf") &&
+                   tree.findCategory("Other_Cat1_Leaf") == tree.verify_find("Other_Cat1_Leaf") &&
+                   tree.getRoot()->findChild("Hub")->children.size() == 99 &&
+                   tree.removePost(&p1) && tree.verify_post_counts({{"root", 0}, {"Other", 0}});
+        });
+        execute_test("PATH-3: Move to the Root, Then Remove", 5, "moveCategory('A_B', 'root') indexes B at the top level; removing it clears the index.", []() {
+            CategoryTreeTester tree;
+            tree.addCategory("A_B_C");
+            Post p1(1, "A_B_C");
+            tree.addPost(&p1);
+            if (!tree.moveCategory("A_B", "root")) return false;
+            if (tree.findCategory("root_B") || tree.findCategory("A_B") || p1.category != "B_C") return false;
+            if (tree.findCategory("B_C") != tree.verify_find("B_C") || !tree.verify_post_counts({{"root", 1}, {"A", 0}, {"B", 1}})) return false;
+            if (!tree.moveCategory("B", "A__") || p1.category != "A_B_C" || tree.findCategory("B")) return false;
+            if (!tree.moveCategory("A_B", "") || !tree.removeCategory("B")) return false;
+            return !tree.findCategory("B") && !tree.findCategory("B_C") && !tree.removePost(&p1) &&
+                   tree.getRoot()->children.size() == 1 && tree.verify_post_counts({{"root", 0}, {"A", 0}});
+        });
+    }
+
+    void test_post_bookkeeping() {
+        cout << "\n--- Part 2: Post Back-References and Incremental Counts ---" << endl;
+        execute_test("BOOK-1: Remove by Back-Reference in a Busy Category", 5, "20000 posts in one category removed in random order.", []() {
+            CategoryTreeTester tree;
+            vector<Post> posts;
+            for (int i = 0; i < 20000; ++i) posts.emplace_back(i, "A_B");
+            for (auto& p : posts) tree.addPost(&p);
+            tree.addPost(&posts[0]);  // already present: ignored
+            vector<int> order(posts.size());
+            for (size_t i = 0; i < order.size(); ++i) order[i] = static_cast<int>(i);
+            std::shuffle(order.begin(), order.end(), std::mt19937(11));
+            for (size_t i = 0; i < order.size() / 2; ++i) {
+                if (!tree.removePost(&posts[order[i]]) || tree.removePost(&posts[order[i]])) return false;
+            }
+            posts[order.back()].category = "Stale_Path";  // lookup must not depend on the string
+            if (!tree.removePost(&posts[order.back()])) return false;
+            set<PostID> expected;
+            for (size_t i = order.size() / 2; i + 1 < order.size(); ++i) expected.insert(order[i]);
+            set<PostID> actual;
+            for (Post* p : tree.getPostsInCategory("A_B", false)) actual.insert(p->postID);
+            return actual == expected && tree.verify_post_counts({{"root", 9999}, {"A", 9999}, {"A_B", 9999}});
+        });
+
+        execute_test("BOOK-2: Incremental Counts Match a Full Recount", 10, "2000 random post adds/removes and category moves/removals.", []() {
+            CategoryTreeTester tree;
+            vector<string> paths = {"A", "A_B", "A_B_C", "A_D", "E", "E_F", "E_F_G", "H"};
+            for (const auto& path : paths) tree.addCategory(path);
+            vector<Post> posts;
+            for (int i = 0; i < 300; ++i) posts.emplace_back(i, paths[i % paths.size()]);
+            vector<bool> live(posts.size(), false);
+            function<int(const shared_ptr<CategoryNode>&)> recount = [&](const shared_ptr<CategoryNode>& node) {
+                int total = static_cast<int>(node->posts.size());
+                for (const auto& child : node->children) total += recount(child);
+                return node->totalPostCount == total ? total : -1000000;
+            };
+            std::mt19937 rng(5);
+            for (int i = 0; i < 2000; ++i) {
+                size_t k = rng() % posts.size();
+                if (i % 250 == 100) {
+                    tree.moveCategory("E_F", rng() % 2 ? "A" : "H");
+                    tree.moveCategory("A_F", "E");
+                    tree.moveCategory("H_F", "E");
+                } else if (live[k]) {
+                    if (!tree.removePost(&posts[k])) return false;
+                    live[k] = false;
+                } else {
+                    tree.addPost(&posts[k]);
+                    live[k] = true;
+                }
+                if (recount(tree.getRoot()) != tree.getRoot()->totalPostCount) return false;
+            }
+            tree.removeCategory("E");
+            return recount(tree.getRoot()) == tree.getRoot()->totalPostCount;
+        });
+    }
+
+    void test_concurrency() {
+        cout << "\n--- Part 3: Concurrent Posting ---" << endl;
+        execute_test("CONC-1: Concurrent Posting During Moves", 10, "4 threads add/remove posts while categories move between subtrees.", []() {
+            CategoryTreeTester tree(true);
+            vector<Post> seeded;
+            for (int i = 0; i < 2000; ++i) seeded.emplace_back(i, "Left_P" + to_string(i % 10));
+            for (auto& p : seeded) tree.addPost(&p);
+            tree.addCategory("Right");
+            vector<vector<Post>> own(4);
+            vector<thread> workers;
+            for (int t = 0; t < 4; ++t) {
+                for (int i = 0; i < 3000; ++i) own[t].emplace_back(10000 * (t + 1) + i, "W" + to_string(t) + (i % 2 ? "_A" : "_B_C"));
+                workers.emplace_back([&, t]() {
+                    for (auto& p : own[t]) tree.addPost(&p);
+                    for (size_t i = 0; i < own[t].size(); i += 2) tree.removePost(&own[t][i]);
+                    for (size_t i = t; i < seeded.size(); i += 8) tree.removePost(&seeded[i]);
+                });
+            }
+            for (int round = 0; round < 100; ++round) {
+                string name = "P" + to_string(round % 10);
+                tree.moveCategory("Left_" + name, "Right");
+                tree.moveCategory("Right_" + name, "Left");
+            }
+            for (auto& worker : workers) worker.join();
+            function<int(const shared_ptr<CategoryNode>&)> recount = [&](const shared_ptr<CategoryNode>& node) {
+                int total = static_cast<int>(node->posts.size());
+                for (const auto& child : node->children) total += recount(child);
+                return node->totalPostCount == total ? total : -1000000;
+            };
+            vector<Post*> all = tree.getPostsInCategory("", true);
+            set<Post*> unique(all.begin(), all.end());
+            int expected = 2000 - 1000 + 4 * 1500;
+            return recount(tree.getRoot()) == expected && all.size() == unique.size() &&
+                   static_cast<int>(all.size()) == expected && tree.getRoot()->findChild("Left")->children.size() == 10;
+        });
+
+        execute_test("CONC-2: Structural Changes in Parallel Subtrees", 10, "4 threads add, move and remove categories in their own subtrees and a shared one while posting.", []() {
+            CategoryTreeTester tree(true);
+            tree.addCategory("Shared_X");
+            tree.addCategory("Shared_Y");
+            vector<vector<Post>> own(4);
+            vector<thread> workers;
+            for (int t = 0; t < 4; ++t) {
+                string home = "T" + to_string(t);
+                for (int i = 0; i < 400; ++i) own[t].emplace_back(10000 * (t + 1) + i, home + "_C" + to_string(i % 8));
+                workers.emplace_back([&, t, home]() {
+                    for (int round = 0; round < 50; ++round) {
+                        string leaf = home + "_C" + to_string(round % 8);
+                        tree.addCategory(leaf + "_Deep");
+                        for (int i = round * 8; i < round * 8 + 8; ++i) tree.addPost(&own[t][i]);
+                        tree.moveCategory(leaf + "_Deep", home);
+                        tree.removeCategory(home + "_Deep");
+                        tree.moveCategory("Shared_" + string(round % 2 ? "X" : "Y"), home);
+                        tree.moveCategory(home + "_" + string(round % 2 ? "X" : "Y"), "Shared");
+                    }
+                });
+            }
+            for (auto& worker : workers) worker.join();
+            function<int(const shared_ptr<CategoryNode>&)> recount = [&](const shared_ptr<CategoryNode>& node) {
+                int total = static_cast<int>(node->posts.size());
+                for (const auto& child : node->children) total += recount(child);
+                return node->totalPostCount == total ? total : -1000000;
+            };
+            for (auto it = tree.preOrderBegin(); it != tree.preOrderEnd(); ++it) {
+                if (*it == tree.getRoot()) continue;
+                string path;
+                for (auto node = *it; node != tree.getRoot(); node = node->parent.lock()) path = node->categoryName + (path.empty() ? "" : "_" + path);
+                if (tree.findCategory(path) != *it) return false;
+            }
+            int remaining = 0;
+            for (int t = 0; t < 4; ++t) {
+                for (auto& p : own[t]) {
+                    if (tree.removePost(&p)) remaining++;
+                }
+            }
+            return remaining == 4 * 400 && recount(tree.getRoot()) == 0 &&
+                   !tree.findCategory("T0_Deep") && tree.getRoot()->findChild("Shared");
+        });
+
+        execute_test("CONC-3: Posters Never Touch the Root's Locks", 5, "Posts into existing subtrees finish while another thread holds both root locks, as a top-level change would.", []() {
+            CategoryTreeTester tree(true);
+            tree.addCategory("A_B");
+            tree.addCategory("C");
+            vector<Post> posts;
+            for (int i = 0; i < 200; ++i) posts.emplace_back(i, i % 2 ? "A_B" : "C");
+            shared_ptr<CategoryNode> root = tree.getRoot();
+            root->lock.lock();
+            root->parentLock.lock();
+            atomic<bool> finished(false);
+            thread poster([&]() {
+                for (auto& p : posts) tree.addPost(&p);
+                for (size_t i = 0; i < posts.size(); i += 2) tree.removePost(&posts[i]);
+                finished = true;
+            });
+            for (int waited = 0; waited < 2000 && !finished; ++waited) this_thread::sleep_for(chrono::milliseconds(1));
+            bool finishedWhileHeld = finished;
+            root->parentLock.unlock();
+            root->lock.unlock();
+            poster.join();
+            return finishedWhileHeld && root->totalPostCount == 100 && tree.findCategory("A_B")->totalPostCount == 100;
+        });
+    }
+
+    void test_traversal() {
+        cout << "\n--- Part 4: Compacted Layout and Parallel Traversal ---" << endl;
+
+        CategoryTreeTester tree;
+        tree.addCategory("Tech_Hardware_CPU");
+        tree.addCategory("Tech_Hardware_GPU");
+        tree.addCategory("Tech_Software");
+        tree.addCategory("Finance");
+        static Post p1(101, "Tech"), p2(102, "Tech_Hardware"), p3(103, "Tech_Hardware_CPU");
+        static Post p4(201, "Tech_Software"), p5(202, "Tech_Software");
+        static Post p6(301, "Finance");
+        tree.addPost(&p1); tree.addPost(&p2); tree.addPost(&p3);
+        tree.addPost(&p4); tree.addPost(&p5); tree.addPost(&p6);
+
+        execute_test("TRAV-1: Subtree Spans from the Compacted Layout", 10, "getPostSpan slices match getPostsInCategory, before and after updates.", [&]() {
+            for (const string path : {"", "Tech", "Tech_Hardware", "Tech_Hardware_GPU", "Finance"}) {
+                PostSpan span = tree.getPostSpan(path);
+                vector<Post*> posts(span.begin(), span.end());
+                if (!tree.verify_get_posts(path, true, posts) ||
+                    static_cast<int>(span.size()) != tree.findCategory(path)->totalPostCount) return false;
+            }
+            static Post p7(104, "Tech_Hardware_GPU");
+            tree.addPost(&p7);
+            bool grown = tree.getPostSpan("Tech").size() == 6 && tree.getPostSpan("Tech_Hardware_GPU")[0] == &p7;
+            tree.removePost(&p7);
+            return grown && tree.getPostSpan("Tech").size() == 5 && tree.getPostSpan("Missing").empty() &&
+                   tree.verify_get_posts("Tech", true, {&p1, &p2, &p3, &p4, &p5});
+        });
+
+        execute_test("TRAV-2: Parallel Reduce", 10, "Summing views and counting nodes over 1000 categories at several grain sizes.", []() {
+            CategoryTreeTester big;
+            vector<Post> posts;
+            posts.reserve(20000);
+            for (int i = 0; i < 20000; ++i) {
+                posts.emplace_back(i, "G" + to_string(i % 50) + "_S" + to_string(i / 50 % 20), i % 97);
+            }
+            long long expected_views = 0;
+            for (auto& p : posts) { big.addPost(&p); expected_views += p.views; }
+            auto views = [](const CategoryNode& node) {
+                long long sum = 0;
+                for (Post* p : node.posts) sum += p->views;
+                return sum;
+            };
+            auto plus = [](long long a, long long b) { return a + b; };
+            auto one = [](const CategoryNode&) { return 1LL; };
+            for (int grain : {1, 100, 1024, 1 << 30}) {
+                if (big.parallelReduce(big.getRoot(), 0LL, views, plus, grain) != expected_views) return false;
+                if (big.parallelReduce(big.getRoot(), 0LL, one, plus, grain) != 1 + 50 + 50 * 20) return false;
+            }
+            if (big.parallelReduce(big.findCategory("G3"), 0LL, one, plus, 1) != 21) return false;
+            try {
+                big.parallelReduce(big.getRoot(), 0LL, [](const CategoryNode& node) -> long long {
+                    if (node.categoryName == "S7") throw runtime_error("boom");
+                    return 0;
+                }, plus, 1);
+                return false;
+            } catch (const runtime_error&) {
+            }
+            return big.parallelReduce(nullptr, 5LL, one, plus) == 5;
+        });
+
+        execute_test("TRAV-3: Concurrent First Calls Share One Pool", 5, "4 threads start parallelReduce on a fresh tree at once.", []() {
+            CategoryTreeTester fresh;
+            for (int i = 0; i < 200; ++i) fresh.addCategory("G" + to_string(i % 20) + "_S" + to_string(i));
+            auto one = [](const CategoryNode&) { return 1LL; };
+            auto plus = [](long long a, long long b) { return a + b; };
+            vector<long long> results(4);
+            vector<thread> callers;
+            for (int t = 0; t < 4; ++t) {
+                callers.emplace_back([&, t]() { results[t] = fresh.parallelReduce(fresh.getRoot(), 0LL, one, plus, 1); });
+            }
+            for (auto& caller : callers) caller.join();
+            return all_of(results.begin(), results.end(), [](long long r) { return r == 1 + 20 + 200; });
+        });
+    }
+};
+
+int main() {
+    TestRunner runner;
+    runner.run_all_tests();
+    return 0;
+}
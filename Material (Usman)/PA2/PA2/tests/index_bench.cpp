@@ -0,0 +1,430 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <map>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <random>
+
+#include "bst.h"
+#include "avl_tree.h"
+#include "bplus_tree.h"
+
+using namespace std;
+
+/**
+ * Ordered-index benchmark: BST, AVLTree, BPlusTree and std::map
+ *
+ * Every backend runs the same four phases on the same key stream:
+ *   insert - n inserts into an empty index
+ *   find   - n lookups
+ *   range  - ranged scans returning RANGE_WIDTH pairs each
+ *   remove - n removals, leaving the index empty
+ *
+ * Key streams:
+ *   sequential - keys 0 .. n-1 in ascending order
+ *   random     - n distinct keys scattered over the int range, in random order
+ *   zipfian    - the random key set, but finds and removes draw keys Zipf(0.99),
+ *                so a few hot keys dominate and most removes after the first miss
+ *
+ * Each operation is timed on its own, so latencies include one steady_clock
+ * read (~20 ns); throughput is ops / phase wall time. Bytes per node is the
+ * growth in live heap bytes (bytes requested from operator new) over the
+ * insert phase, divided by the number of keys stored.
+ *
+ * Usage: index_bench [--sizes 1000,100000,1000000] [--streams sequential,random,zipfian]
+ *                    [--backends bst,avl,bplus,map] [--csv FILE] [--seed N]
+ * Sizes up to 10000000 are supported; the unbalanced BST is skipped on the
+ * sequential stream above BST_SEQUENTIAL_LIMIT keys, where it degenerates
+ * into a list (quadratic time and recursion depth n).
+ */
+
+// ---------------------------------------------------------------------------
+// Live heap accounting
+// ---------------------------------------------------------------------------
+
+// Atomic: the replaced operator new serves every thread in the process
+static atomic<size_t> liveHeapBytes{0};
+
+// Each block starts with a header holding its requested size, so delete can
+// subtract it without an allocator-specific size query
+static const size_t HEAP_HEADER = alignof(max_align_t);
+
+void* operator new(size_t size) {
+    char* block = static_cast<char*>(malloc(HEAP_HEADER + size));
+    if (!block) throw bad_alloc();
+    *reinterpret_cast<size_t*>(block) = size;
+    liveHeapBytes += size;
+    return block + HEAP_HEADER;
+}
+
+void operator delete(void* ptr) noexcept {
+    if (!ptr) return;
+    char* block = static_cast<char*>(ptr) - HEAP_HEADER;
+    liveHeapBytes -= *reinterpret_cast<size_t*>(block);
+    free(block);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    operator delete(ptr);
+}
+
+// ---------------------------------------------------------------------------
+// Backends: a uniform face over each index so the phases are written once.
+// To benchmark a new index, add an adapter here and a line in makeRunners().
+// ---------------------------------------------------------------------------
+
+const size_t RANGE_WIDTH = 100;
+const size_t BST_SEQUENTIAL_LIMIT = 10000;
+
+struct BSTBackend {
+    static const char* name() { return "bst"; }
+    BST<int, int> index;
+    bool insert(int key) { return index.insert(key, key); }
+    bool find(int key) const { return index.find(key) != nullptr; }
+    bool remove(int key) { return index.remove(key); }
+    size_t range(int lo, int hi) const { return index.findRange(lo, hi).size(); }
+};
+
+struct AVLBackend {
+    static const char* name() { return "avl"; }
+    AVLTree<int, int> index;
+    bool insert(int key) { return index.insert(key, key); }
+    bool find(int key) const { return index.find(key) != nullptr; }
+    bool remove(int key) { return index.remove(key); }
+    size_t range(int lo, int hi) const { return index.findRange(lo, hi).size(); }
+};
+
+struct BPlusBackend {
+    static const char* name() { return "bplus"; }
+    BPlusTree<int, int> index;
+    bool insert(int key) { return index.insert(key, key); }
+    bool find(int key) const { return index.find(key) != nullptr; }
+    bool remove(int key) { return index.remove(key); }
+    size_t range(int lo, int hi) const { return index.findRange(lo, hi).size(); }
+};
+
+struct MapBackend {
+    static const char* name() { return "map"; }
+    map<int, int> index;
+    bool insert(int key) { return index.emplace(key, key).second; }
+    bool find(int key) const { return index.find(key) != index.end(); }
+    bool remove(int key) { return index.erase(key) > 0; }
+    size_t range(int lo, int hi) const {
+        // Materialise the pairs like findRange does, so the comparison is like for like
+        vector<pair<int, int>> result;
+        for (auto it = index.lower_bound(lo); it != index.end() && it->first <= hi; ++it) {
+            result.push_back(*it);
+        }
+        return result.size();
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Key streams
+// ---------------------------------------------------------------------------
+
+// Bijective 32-bit mixer, so scrambled keys stay distinct
+uint32_t scramble(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x7feb352dU;
+    x ^= x >> 15;
+    x *= 0x846ca68bU;
+    x ^= x >> 16;
+    return x;
+}
+
+/**
+ * Zipfian ranks in [0, n) with skew theta (Gray et al., "Quickly generating
+ * billion-record synthetic databases"); O(n) setup, O(1) per draw.
+ */
+class ZipfGenerator {
+    size_t n;
+    double theta, alpha, zetan, eta;
+    uniform_real_distribution<double> unit;
+
+    static double zeta(size_t count, double theta) {
+        double sum = 0;
+        for (size_t i = 1; i <= count; ++i) sum += 1.0 / pow(static_cast<double>(i), theta);
+        return sum;
+    }
+
+public:
+    ZipfGenerator(size_t n, double theta) : n(n), theta(theta), unit(0.0, 1.0) {
+        double zeta2 = zeta(2, theta);
+        zetan = zeta(n, theta);
+        alpha = 1.0 / (1.0 - theta);
+        eta = (1.0 - pow(2.0 / n, 1.0 - theta)) / (1.0 - zeta2 / zetan);
+    }
+
+    size_t next(mt19937_64& rng) {
+        double u = unit(rng);
+        double uz = u * zetan;
+        if (uz < 1.0) return 0;
+        if (uz < 1.0 + pow(0.5, theta)) return 1;
+        size_t rank = static_cast<size_t>(n * pow(eta * u - eta + 1.0, alpha));
+        return min(rank, n - 1);
+    }
+};
+
+struct Workload {
+    string stream;
+    vector<int> inserts;       // insert phase order
+    vector<int> finds;         // find phase keys
+    vector<int> removes;       // remove phase order
+    vector<pair<int, int>> ranges;  // [lo, hi] spanning RANGE_WIDTH stored keys
+};
+
+Workload makeWorkload(const string& stream, size_t n, uint64_t seed) {
+    Workload w;
+    w.stream = stream;
+    mt19937_64 rng(seed);
+    w.inserts.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        w.inserts[i] = stream == "sequential" ? static_cast<int>(i)
+                                              : static_cast<int>(scramble(static_cast<uint32_t>(i)));
+    }
+
+    vector<int> sorted = w.inserts;
+    sort(sorted.begin(), sorted.end());
+
+    if (stream == "sequential") {
+        w.finds = w.inserts;
+        w.removes = w.inserts;
+    } else if (stream == "random") {
+        shuffle(w.inserts.begin(), w.inserts.end(), rng);
+        w.finds = w.inserts;
+        shuffle(w.finds.begin(), w.finds.end(), rng);
+        w.removes = w.finds;
+        shuffle(w.removes.begin(), w.removes.end(), rng);
+    } else {
+        shuffle(w.inserts.begin(), w.inserts.end(), rng);
+        // Hot ranks map to scattered keys, not to the smallest ones
+        ZipfGenerator zipf(n, 0.99);
+        w.finds.resize(n);
+        w.removes.resize(n);
+        for (size_t i = 0; i < n; ++i) w.finds[i] = w.inserts[zipf.next(rng)];
+        for (size_t i = 0; i < n; ++i) w.removes[i] = w.inserts[zipf.next(rng)];
+    }
+
+    size_t rangeCount = min<size_t>(max<size_t>(n / 10, 1), 100000);
+    if (n >= RANGE_WIDTH) {
+        uniform_int_distribution<size_t> startRank(0, n - RANGE_WIDTH);
+        for (size_t i = 0; i < rangeCount; ++i) {
+            size_t first = startRank(rng);
+            w.ranges.push_back({sorted[first], sorted[first + RANGE_WIDTH - 1]});
+        }
+    }
+    return w;
+}
+
+// ---------------------------------------------------------------------------
+// Measurement
+// ---------------------------------------------------------------------------
+
+struct PhaseResult {
+    string op;
+    size_t ops = 0;
+    size_t hits = 0;           // successful inserts/finds/removes, or pairs returned by ranges
+    double seconds = 0;
+    double p50Ns = 0;
+    double p99Ns = 0;
+};
+
+struct BenchRow {
+    string backend;
+    string stream;
+    size_t n;
+    double bytesPerNode;
+    vector<PhaseResult> phases;
+};
+
+double percentile(vector<uint32_t>& samples, double fraction) {
+    if (samples.empty()) return 0;
+    size_t k = min(samples.size() - 1, static_cast<size_t>(fraction * samples.size()));
+    nth_element(samples.begin(), samples.begin() + k, samples.end());
+    return samples[k];
+}
+
+template<typename Item, typename Op>
+PhaseResult timePhase(const string& name, const vector<Item>& items, vector<uint32_t>& latencies, Op op) {
+    PhaseResult result;
+    result.op = name;
+    result.ops = items.size();
+    latencies.resize(items.size());
+    auto phaseStart = chrono::steady_clock::now();
+    auto last = phaseStart;
+    for (size_t i = 0; i < items.size(); ++i) {
+        result.hits += op(items[i]);
+        auto now = chrono::steady_clock::now();
+        latencies[i] = static_cast<uint32_t>(min<int64_t>(
+            chrono::duration_cast<chrono::nanoseconds>(now - last).count(), UINT32_MAX));
+        last = now;
+    }
+    result.seconds = chrono::duration<double>(last - phaseStart).count();
+    result.p50Ns = percentile(latencies, 0.50);
+    result.p99Ns = percentile(latencies, 0.99);
+    return result;
+}
+
+template<typename Backend>
+BenchRow runBackend(const Workload& w, vector<uint32_t>& latencies) {
+    BenchRow row;
+    row.backend = Backend::name();
+    row.stream = w.stream;
+    row.n = w.inserts.size();
+
+    size_t heapBefore = liveHeapBytes.load();
+    {
+        Backend backend;
+        row.phases.push_back(timePhase("insert", w.inserts, latencies,
+                                       [&](int key) { return backend.insert(key); }));
+        size_t stored = row.phases.back().hits;
+        row.bytesPerNode = stored ? static_cast<double>(liveHeapBytes.load() - heapBefore) / stored : 0;
+        row.phases.push_back(timePhase("find", w.finds, latencies,
+                                       [&](int key) { return backend.find(key); }));
+        row.phases.push_back(timePhase("range", w.ranges, latencies,
+                                       [&](const pair<int, int>& r) { return backend.range(r.first, r.second); }));
+        row.phases.push_back(timePhase("remove", w.removes, latencies,
+                                       [&](int key) { return backend.remove(key); }));
+        // Zipfian removes leave most keys behind; let the destructor free them untimed
+    }
+    return row;
+}
+
+// ---------------------------------------------------------------------------
+// Driver
+// ---------------------------------------------------------------------------
+
+typedef BenchRow (*Runner)(const Workload&, vector<uint32_t>&);
+
+vector<pair<string, Runner>> makeRunners() {
+    return {
+        {BSTBackend::name(), &runBackend<BSTBackend>},
+        {AVLBackend::name(), &runBackend<AVLBackend>},
+        {BPlusBackend::name(), &runBackend<BPlusBackend>},
+        {MapBackend::name(), &runBackend<MapBackend>},
+    };
+}
+
+vector<string> splitList(const string& text) {
+    vector<string> parts;
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t comma = text.find(',', start);
+        if (comma == string::npos) comma = text.size();
+        if (comma > start) parts.push_back(text.substr(start, comma - start));
+        start = comma + 1;
+    }
+    return parts;
+}
+
+void printRow(const BenchRow& row) {
+    for (const PhaseResult& p : row.phases) {
+        double mops = p.seconds > 0 ? p.ops / p.seconds / 1e6 : 0;
+        cout << "  " << left << setw(8) << row.backend << setw(12) << row.stream << right
+             << setw(10) << row.n << "  " << left << setw(7) << p.op << right
+             << setw(10) << fixed << setprecision(3) << mops
+             << setw(10) << setprecision(0) << p.p50Ns
+             << setw(10) << p.p99Ns
+             << setw(10) << setprecision(1) << row.bytesPerNode << endl;
+    }
+}
+
+void writeCsv(ostream& out, const vector<BenchRow>& rows) {
+    out << "backend,stream,n,op,ops,hits,seconds,mops_per_sec,p50_ns,p99_ns,bytes_per_node\n";
+    for (const BenchRow& row : rows) {
+        for (const PhaseResult& p : row.phases) {
+            out << row.backend << ',' << row.stream << ',' << row.n << ',' << p.op << ','
+                << p.ops << ',' << p.hits << ',' << p.seconds << ','
+                << (p.seconds > 0 ? p.ops / p.seconds / 1e6 : 0) << ','
+                << p.p50Ns << ',' << p.p99Ns << ',' << row.bytesPerNode << '\n';
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    vector<size_t> sizes = {1000, 100000, 1000000};
+    vector<string> streams = {"sequential", "random", "zipfian"};
+    vector<string> backends;
+    string csvFile;
+    uint64_t seed = 42;
+
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (i + 1 >= argc) {
+            cerr << "Missing value for " << arg << endl;
+            return 2;
+        }
+        string value = argv[++i];
+        if (arg == "--sizes") {
+            sizes.clear();
+            for (const string& s : splitList(value)) sizes.push_back(strtoull(s.c_str(), nullptr, 10));
+        } else if (arg == "--streams") {
+            streams = splitList(value);
+        } else if (arg == "--backends") {
+            backends = splitList(value);
+        } else if (arg == "--csv") {
+            csvFile = value;
+        } else if (arg == "--seed") {
+            seed = strtoull(value.c_str(), nullptr, 10);
+        } else {
+            cerr << "Unknown option " << arg << endl;
+            return 2;
+        }
+    }
+    for (const string& stream : streams) {
+        if (stream != "sequential" && stream != "random" && stream != "zipfian") {
+            cerr << "Unknown stream " << stream << endl;
+            return 2;
+        }
+    }
+
+    cout << "=======================================================================" << endl;
+    cout << "                    Ordered Index Benchmark" << endl;
+    cout << "=======================================================================" << endl;
+    cout << "  " << left << setw(8) << "index" << setw(12) << "stream" << right << setw(10) << "n"
+         << "  " << left << setw(7) << "op" << right << setw(10) << "Mops/s"
+         << setw(10) << "p50 ns" << setw(10) << "p99 ns" << setw(10) << "B/node" << endl;
+    cout << "-----------------------------------------------------------------------" << endl;
+
+    vector<BenchRow> rows;
+    vector<uint32_t> latencies;
+    for (size_t n : sizes) {
+        for (const string& stream : streams) {
+            Workload workload = makeWorkload(stream, n, seed);
+            for (const auto& runner : makeRunners()) {
+                if (!backends.empty() && find(backends.begin(), backends.end(), runner.first) == backends.end()) {
+                    continue;
+                }
+                if (runner.first == "bst" && stream == "sequential" && n > BST_SEQUENTIAL_LIMIT) {
+                    cout << "  " << left << setw(8) << runner.first << setw(12) << stream << right
+                         << setw(10) << n << "  skipped (degenerates to a list)" << endl;
+                    continue;
+                }
+                rows.push_back(runner.second(workload, latencies));
+                printRow(rows.back());
+            }
+        }
+    }
+    cout << "=======================================================================" << endl;
+
+    if (!csvFile.empty()) {
+        ofstream out(csvFile);
+        if (!out) {
+            cerr << "Could not write " << csvFile << endl;
+            return 1;
+        }
+        writeCsv(out, rows);
+        cout << "CSV written to " << csvFile << endl;
+    }
+    return 0;
+}
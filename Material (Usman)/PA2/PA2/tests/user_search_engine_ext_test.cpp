@@ -0,0 +1,340 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <functional>
+#include <memory>
+#include <algorithm>
+#include <iomanip>
+#include <stdexcept>
+#include <set>
+#include <map>
+#include <random>
+#include <thread>
+#include <atomic>
+
+// Include the header for the code being tested
+#include "user_search_engine.h"
+// Include the AVLTester for the order-statistic checks
+#include "avl_test.h"
+
+using namespace std;
+
+// Checks for the order-statistic, name-search and alternative-index extensions.
+// Ungraded: the graded behaviour lives in user_search_engine_test.cpp.
+class UserSearchEngineTester : public UserSearchEngine {
+public:
+    using UserSearchEngine::UserSearchEngine;
+
+    size_t substring_candidates(const string& fragment) const {
+        vector<pair<string, User*>> matches;
+        size_t candidates = 0;
+        if (backend == SNAPSHOT_AVL_INDEX) {
+            publishedSnapshot.load()->nameTrigrams.search(fragment, matches, 0, &candidates);
+        } else {
+            usernameTrigrams.search(fragment, matches, &candidates);
+        }
+        return candidates;
+    }
+};
+
+
+class TestRunner {
+public:
+    TestRunner() {
+        // Create a pool of users that the test suite will own
+        for(int i=0; i < 200; ++i) {
+            user_pool.emplace_back(i, "user" + to_string(i));
+        }
+    }
+
+    void run_all_tests() {
+        cout << "=======================================================================" << endl;
+        cout << "                 User Search Engine Tester (extensions)" << endl;
+        cout << "=======================================================================" << endl;
+
+        test_order_statistics();
+        test_name_search();
+        test_alternative_indexes();
+
+        cout << "\n-----------------------------------------------------------------------" << endl;
+        cout << "                           TESTING SUMMARY" << endl;
+        cout << "-----------------------------------------------------------------------" << endl;
+        cout << "  FINAL SCORE: " << total_score << " / " << max_score << endl;
+        if (total_score == max_score) {
+            cout << "  RESULT: All tests passed!" << endl;
+        } else {
+            cout << "  RESULT: Some tests failed." << endl;
+        }
+        cout << "=======================================================================" << endl;
+    }
+
+private:
+    int total_score = 0;
+    int max_score = 0;
+    vector<User> user_pool;
+
+    void execute_test(const string& name, int points, const string& desc, const function<bool()>& test_func) {
+        max_score += points;
+        cout << "\n  - " << name << " [" << points << " pts]" << endl;
+        cout << "    " << desc << endl;
+        cout << "    Running test... ";
+        if (test_func()) {
+            cout << "PASSED" << endl;
+            total_score += points;
+        } else {
+            cout << "FAILED" << endl;
+        }
+    }
+
+    // --- Test Suites ---
+
+    void test_order_statistics() {
+        cout << "\n--- Part 1: Order Statistics (rank, select, count, page) ---" << endl;
+        UserSearchEngineTester engine;
+        for(int i=0; i<100; ++i) engine.addUser(&user_pool[i]);
+
+        execute_test("ORD-1: AVL Order Statistics After Rotations", 10, "rank/select/countRange agree with a sorted set through inserts and removals.", []() {
+            AVLTester<int, string> avl;
+            std::mt19937 rng(321);
+            vector<int> data;
+            for (int i = 0; i < 300; ++i) data.push_back(i * 2);
+            std::shuffle(data.begin(), data.end(), rng);
+            set<int> current_keys;
+            for (int key : data) { avl.insert(key, ""); current_keys.insert(key); }
+            for (size_t i = 0; i < 100; ++i) { avl.remove(data[i]); current_keys.erase(data[i]); }
+
+            vector<int> sorted(current_keys.begin(), current_keys.end());
+            for (size_t k = 0; k < sorted.size(); ++k) {
+                if (avl.select(k).first != sorted[k]) return false;
+                if (avl.rank(sorted[k]) != k) return false;
+            }
+            if (avl.rank(-1) != 0 || avl.rank(1000) != sorted.size()) return false;
+            for (int lo = -5; lo < 610; lo += 37) {
+                for (int hi = lo; hi < 610; hi += 53) {
+                    size_t expected = distance(current_keys.lower_bound(lo), current_keys.upper_bound(hi));
+                    if (avl.countRange(lo, hi) != expected) return false;
+                }
+            }
+            auto page = avl.selectRange(10, 5);
+            if (page.size() != 5 || page[0].first != sorted[10] || page[4].first != sorted[14]) return false;
+            return avl.countRange(10, 5) == 0 && avl.selectRange(sorted.size(), 1).empty();
+        });
+
+        execute_test("ORD-2: ID Range Count and Pagination", 5, "Counting IDs in [15, 20] and fetching page 3 (size 7) by ID and name.", [&]() {
+            if (engine.countUsersInIDRange(15, 20) != 6 || engine.countUsersInIDRange(60, 50) != 0) return false;
+            if (engine.countUsersInIDRange(-100, 1000) != 100) return false;
+            auto by_id = engine.getUsersPage(3, 7, true);
+            auto by_name = engine.getUsersPage(3, 7, false);
+            auto all_names = engine.getAllUsersSorted(false);
+            if (by_id.size() != 7 || by_id[0]->userID != 21 || by_id.back()->userID != 27) return false;
+            if (by_name.size() != 7 || by_name[0] != all_names[21]) return false;
+            return engine.getUsersPage(14, 7).size() == 2 && engine.getUsersPage(15, 7).empty();
+        });
+    }
+
+    void test_name_search() {
+        cout << "\n--- Part 2: Username Search (prefix, substring, fuzzy) ---" << endl;
+        UserSearchEngineTester engine;
+        for(int i=0; i<100; ++i) engine.addUser(&user_pool[i]);
+
+        execute_test("NAME-1: Prefix Search with Limit", 5, "Type-ahead over names that share and split edges; results stay sorted and capped.", [&]() {
+            UserSearchEngineTester trie_engine;
+            vector<User> names = {User(1, "ann"), User(2, "anna"), User(3, "annabel"), User(4, "anne"),
+                                  User(5, "bob"), User(6, "an"), User(7, "andrew"), User(8, "zed")};
+            for (auto& u : names) trie_engine.addUser(&u);
+            trie_engine.removeUser("anna");  // leaves "ann" -> "annabel" as a folded edge
+            auto all_an = trie_engine.searchByUsernamePrefix("an");
+            vector<string> got;
+            for (User* u : all_an) got.push_back(u->userName);
+            if (got != vector<string>({"an", "andrew", "ann", "annabel", "anne"})) return false;
+            auto capped = trie_engine.searchByUsernamePrefix("ann", 2);
+            if (capped.size() != 2 || capped[0]->userName != "ann" || capped[1]->userName != "annabel") return false;
+            if (!trie_engine.searchByUsernamePrefix("annab").size() || !trie_engine.searchByUsernamePrefix("annx").empty()) return false;
+            return trie_engine.isConsistent() && engine.searchByUsernamePrefix("user", 3).size() == 3;
+        });
+
+        execute_test("NAME-2: Substring Search", 10, "'contains' queries vs brute force on 2000 names with removals; rare fragments only verify their few candidates.", [&]() {
+            auto basic = engine.searchByUsernameSubstring("er5");
+            if (basic.size() != 11 || basic[0]->userName != "user5" || basic[1]->userName != "user50") return false;
+            if (engine.searchByUsernameSubstring("er5", 3).size() != 3 || !engine.searchByUsernameSubstring("zz").empty()) return false;
+            if (engine.searchByUsernameSubstring("").size() != 100) return false;
+
+            std::mt19937 rng(7);
+            vector<User> users;
+            for (int i = 0; i < 2000; ++i) {
+                string name;
+                int len = 4 + rng() % 7;
+                for (int c = 0; c < len; ++c) name += char('a' + rng() % 8);
+                if (i % 400 == 1) name.insert(rng() % name.size(), "xyzzy");
+                users.emplace_back(i, name);
+            }
+            UserSearchEngineTester avl_engine;
+            UserSearchEngineTester snapshot_engine(SNAPSHOT_AVL_INDEX);
+            set<User*> live;
+            for (auto& u : users) {
+                if (avl_engine.addUser(&u)) live.insert(&u);
+                snapshot_engine.addUser(&u);
+            }
+            for (int i = 0; i < 2000; i += 5) {
+                if (avl_engine.removeUser(i)) live.erase(&users[i]);
+                snapshot_engine.removeUser(i);
+            }
+            for (int q = 0; q < 60; ++q) {
+                const string& source = users[rng() % users.size()].userName;
+                size_t len = 1 + q % 5;
+                string fragment = source.substr(rng() % source.size(), len);
+                vector<string> expected;
+                for (User* u : live) if (u->userName.find(fragment) != string::npos) expected.push_back(u->userName);
+                sort(expected.begin(), expected.end());
+                for (auto* e : {&avl_engine, &snapshot_engine}) {
+                    vector<string> got;
+                    for (User* u : e->searchByUsernameSubstring(fragment)) got.push_back(u->userName);
+                    if (got != expected) return false;
+                }
+            }
+            // Only the planted names share "xyz"/"yzz"/"zzy", so at most 5 candidates are verified
+            auto rare = avl_engine.searchByUsernameSubstring("xyzzy");
+            if (rare.empty() || avl_engine.substring_candidates("xyzzy") > 5) return false;
+            return avl_engine.isConsistent();
+        });
+
+        execute_test("NAME-3: Fuzzy Search Matches Brute Force", 10, "500 random names (some over 64 chars), removals, distances 0-3, AVL and snapshot.", [&]() {
+            auto edit_distance = [](const string& a, const string& b) {
+                vector<vector<int>> dp(a.size() + 1, vector<int>(b.size() + 1));
+                for (size_t i = 0; i <= a.size(); ++i) dp[i][0] = i;
+                for (size_t j = 0; j <= b.size(); ++j) dp[0][j] = j;
+                for (size_t i = 1; i <= a.size(); ++i)
+                    for (size_t j = 1; j <= b.size(); ++j)
+                        dp[i][j] = min({dp[i-1][j] + 1, dp[i][j-1] + 1, dp[i-1][j-1] + (a[i-1] != b[j-1])});
+                return dp[a.size()][b.size()];
+            };
+            std::mt19937 rng(99);
+            vector<User> users;
+            for (int i = 0; i < 500; ++i) {
+                string name;
+                int len = (i % 50 == 0) ? 70 + rng() % 10 : 3 + rng() % 6;
+                for (int c = 0; c < len; ++c) name += char('a' + rng() % 4);
+                users.emplace_back(i, name);
+            }
+            UserSearchEngineTester fuzzy_engine;
+            UserSearchEngineTester snapshot_engine(SNAPSHOT_AVL_INDEX);
+            set<User*> live;
+            for (auto& u : users) {
+                if (fuzzy_engine.addUser(&u)) live.insert(&u);
+                snapshot_engine.addUser(&u);
+            }
+            for (int i = 0; i < 500; i += 3) {
+                if (fuzzy_engine.removeUser(i)) live.erase(&users[i]);
+                snapshot_engine.removeUser(i);
+            }
+            for (int q = 0; q < 40; ++q) {
+                string query = users[rng() % users.size()].userName;
+                if (q % 4 == 0) query += char('a' + rng() % 4);
+                int dist = q % 4;
+                set<User*> expected;
+                for (User* u : live) if (edit_distance(query, u->userName) <= dist) expected.insert(u);
+                for (auto* e : {&fuzzy_engine, &snapshot_engine}) {
+                    auto results = e->fuzzyUsernameSearch(query, dist);
+                    if (set<User*>(results.begin(), results.end()) != expected || results.size() != expected.size()) return false;
+                }
+            }
+            return fuzzy_engine.isConsistent() && snapshot_engine.isConsistent();
+        });
+
+        execute_test("NAME-4: Substring Index Through Heavy Churn", 5, "2000 'userN' names, 1900 removed and 500 re-added, AVL and snapshot; results match brute force, rare fragments stay cheap.", [&]() {
+            vector<User> users;
+            for (int i = 0; i < 2000; ++i) users.emplace_back(i, "user" + to_string(i));
+            for (IndexBackend backend : {AVL_INDEX, SNAPSHOT_AVL_INDEX}) {
+                UserSearchEngineTester churn_engine(backend);
+                set<User*> live;
+                for (auto& u : users) if (churn_engine.addUser(&u)) live.insert(&u);
+                for (int i = 0; i < 1900; ++i) if (churn_engine.removeUser(i)) live.erase(&users[i]);
+                for (int i = 0; i < 2000; i += 4) if (churn_engine.addUser(&users[i])) live.insert(&users[i]);
+                for (const string& fragment : {string("user"), string("r19"), string("99"), string("er5"), string("1234")}) {
+                    vector<string> expected;
+                    for (User* u : live) if (u->userName.find(fragment) != string::npos) expected.push_back(u->userName);
+                    sort(expected.begin(), expected.end());
+                    vector<string> got;
+                    for (User* u : churn_engine.searchByUsernameSubstring(fragment)) got.push_back(u->userName);
+                    if (got != expected) return false;
+                    auto capped = churn_engine.searchByUsernameSubstring(fragment, 3);
+                    if (capped.size() != min<size_t>(3, expected.size())) return false;
+                    for (size_t k = 0; k < capped.size(); ++k) if (capped[k]->userName != expected[k]) return false;
+                }
+                // Every name contains "use", but only user1999 has all of "r19", "199" and "999"
+                if (churn_engine.substring_candidates("r1999") != 1 || !churn_engine.isConsistent()) return false;
+            }
+            return true;
+        });
+    }
+
+    void test_alternative_indexes() {
+        cout << "\n--- Part 3: Alternative Index Backends ---" << endl;
+
+        execute_test("BACK-1: B+ Tree Backend Mixed Operations", 10, "1000 random add/remove ops, compared against an AVL-backed engine.", [&]() {
+            UserSearchEngine bplus_engine(BPLUS_TREE_INDEX);
+            UserSearchEngine avl_engine;
+            std::mt19937 rng(777);
+            for (int i = 0; i < 1000; ++i) {
+                User* u = &user_pool[rng() % user_pool.size()];
+                if (rng() % 2) {
+                    if (bplus_engine.addUser(u) != avl_engine.addUser(u)) return false;
+                } else {
+                    if (bplus_engine.removeUser(u->userID) != avl_engine.removeUser(u->userID)) return false;
+                }
+            }
+            if (!bplus_engine.isConsistent() || bplus_engine.getTotalUsers() != avl_engine.getTotalUsers()) return false;
+            return bplus_engine.getAllUsersSorted(false) == avl_engine.getAllUsersSorted(false) &&
+                   bplus_engine.searchByUsernamePrefix("user1") == avl_engine.searchByUsernamePrefix("user1") &&
+                   bplus_engine.getUsersInIDRange(40, 120) == avl_engine.getUsersInIDRange(40, 120) &&
+                   bplus_engine.countUsersInIDRange(40, 120) == avl_engine.countUsersInIDRange(40, 120) &&
+                   bplus_engine.getUsersPage(2, 9, false) == avl_engine.getUsersPage(2, 9, false);
+        });
+
+        execute_test("BACK-2: Snapshot Readers During Writes", 10, "4 reader threads query while a writer adds and removes 1000 users.", [&]() {
+            UserSearchEngine engine(SNAPSHOT_AVL_INDEX);
+            for (size_t i = 0; i < user_pool.size(); i += 2) engine.addUser(&user_pool[i]);
+            atomic<bool> done(false);
+            atomic<bool> failed(false);
+            vector<thread> readers;
+            for (int r = 0; r < 4; ++r) {
+                readers.emplace_back([&, r]() {
+                    std::mt19937 rng(31 + r);
+                    while (!done.load()) {
+                        int id = rng() % 200;
+                        User* u = engine.searchByID(id);
+                        if (u && u->userID != id) failed = true;
+                        vector<User*> range = engine.getUsersInIDRange(id, id + 40);
+                        for (size_t k = 0; k < range.size(); ++k) {
+                            if (range[k]->userID < id || range[k]->userID > id + 40) failed = true;
+                            if (k > 0 && range[k - 1]->userID >= range[k]->userID) failed = true;
+                        }
+                        for (User* named : engine.searchByUsernameSubstring("er1", 5)) {
+                            if (named->userName.find("er1") == string::npos) failed = true;
+                        }
+                        for (User* near : engine.fuzzyUsernameSearch("user" + to_string(id), 1)) {
+                            if (near->userName.size() < 4 || near->userName.compare(0, 4, "user") != 0) failed = true;
+                        }
+                        if (!engine.isConsistent()) failed = true;
+                    }
+                });
+            }
+            std::mt19937 rng(99);
+            for (int i = 0; i < 1000; ++i) {
+                User* u = &user_pool[rng() % user_pool.size()];
+                if (rng() % 2) engine.addUser(u);
+                else engine.removeUser(u->userName);
+            }
+            done = true;
+            for (auto& reader : readers) reader.join();
+            return !failed && engine.isConsistent() &&
+                   engine.getAllUsersSorted(true).size() == engine.getTotalUsers();
+        });
+    }
+};
+
+int main() {
+    TestRunner runner;
+    runner.run_all_tests();
+    return 0;
+}
@@ -0,0 +1,126 @@
+#ifndef CONCURRENT_HASHTABLE_H
+#define CONCURRENT_HASHTABLE_H
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <memory>
+#include <type_traits>
+#include "HashTables.h"
+using namespace std;
+
+// Thread-safe counterpart of HashTable for maps shared between threads.
+//
+// The key space is split into STRIPE_COUNT stripes by the top bits of the
+// hash. Each stripe is an independent linear-probing table guarded by its own
+// mutex, so writers to different stripes never wait for each other, and
+// growing one stripe does not stop the others.
+//
+// Readers take no lock. Every slot carries a version counter that a writer
+// makes odd while it changes the slot; a reader copies the slot and retries if
+// the version moved (a seqlock per slot). Removed keys leave tombstones, so a
+// slot never turns empty again while a reader may be walking past it. A resize
+// builds a new array and publishes it with one atomic store.
+//
+// Old arrays are reclaimed by epochs. A search pins the table's current epoch
+// in a reader slot of its own, so readers never write a shared cache line. A
+// replaced array is tagged with the epoch it was retired in, and freed once
+// every pinned search began after that, so arrays drain while reads go on.
+//
+// Readers load keys and values while a writer may be changing them, so the
+// slot fields are atomics accessed with relaxed ordering and only the version
+// orders them; keys and values must therefore be trivially copyable.
+template <typename T, typename K = int, typename Hasher = StrongHash<K>>
+class ConcurrentHashTable
+{
+    static_assert(is_trivially_copyable<K>::value && is_trivially_copyable<T>::value,
+                  "ConcurrentHashTable reads slots optimistically; keys and values must be trivially copyable");
+
+    private:
+        static const int STRIPE_BITS = 6;
+        static const int STRIPE_COUNT = 1 << STRIPE_BITS;
+        static const int INITIAL_STRIPE_SIZE = 16;          // slots per stripe; always a power of two.
+        static const int MAX_READERS = 128;                 // concurrent searches; extra readers wait for a slot.
+        static const uint64_t IDLE = 0;
+
+        enum SlotState : uint8_t
+        {
+            SLOT_EMPTY,
+            SLOT_OCCUPIED,
+            SLOT_TOMBSTONE
+        };
+
+        struct Slot
+        {
+            atomic<uint32_t> version{0};                    // odd while a writer is changing the slot.
+            atomic<SlotState> state{SLOT_EMPTY};            // fields are relaxed; the version orders them.
+            atomic<K> key{K()};
+            atomic<T> value{T()};
+        };
+
+        struct Storage
+        {
+            int size;
+            unique_ptr<Slot[]> slots;
+
+            explicit Storage(int n) : size(n), slots(new Slot[n]) {}
+        };
+
+        struct alignas(64) ReaderSlot                       // one cache line per reader, so pins do not false-share.
+        {
+            atomic<uint64_t> epoch{IDLE};                   // epoch pinned by the search in progress, or IDLE.
+            atomic<bool> claimed{false};
+        };
+
+        struct alignas(64) Stripe                           // one cache line apart, so stripes do not false-share.
+        {
+            mutex writeLock;
+            atomic<Storage*> storage{nullptr};
+            atomic<int> num_elements{0};
+            int num_tombstones = 0;                         // writers only.
+            vector<pair<uint64_t, unique_ptr<Storage>>> retired;    // (retire epoch, replaced array) a reader may still hold.
+        };
+
+        Hasher hasher;
+        Stripe stripes[STRIPE_COUNT];
+        atomic<uint64_t> globalEpoch{1};
+        ReaderSlot readers[MAX_READERS];
+        float loadFactorThreshold = 0.85;
+        float tombstoneRatioThreshold = 0.2;
+
+        Stripe& stripeOf(uint64_t hash) {return stripes[hash >> (64 - STRIPE_BITS)];}
+
+        static void beginWrite(Slot& slot);
+        static void endWrite(Slot& slot);
+
+        bool readSlot(const Slot& slot, SlotState& state, K& key, T& value) const;  // false if a writer interfered.
+
+        int findSlot(const Storage& storage, uint64_t hash, const K& key) const;    // writers only; index or -1.
+        void rehashStripe(Stripe& stripe, int size);        // publish a fresh array of this size; caller holds writeLock.
+        void reclaim(Stripe& stripe);                       // free retired arrays that no pinned reader can still see.
+        uint64_t oldestPinnedEpoch() const;                 // UINT64_MAX if no search is in progress.
+        int pinReader();                                    // claim a reader slot and pin the current epoch in it.
+        void unpinReader(int slot);
+        void checkLoad(Stripe& stripe);
+
+    public:
+        ConcurrentHashTable(const Hasher& hash = Hasher());
+        ~ConcurrentHashTable();
+
+        ConcurrentHashTable(const ConcurrentHashTable&) = delete;
+        ConcurrentHashTable& operator=(const ConcurrentHashTable&) = delete;
+
+        void insert(const K& key, T value);                 // insert a key-value pair (or update the value of an existing key).
+
+        T search(const K& key);                             // value for key, or T() if absent; never blocks.
+
+        void remove(const K& key);
+
+        int getTableSize();                                 // slots over all stripes.
+
+        int getNumberElements();
+
+        int getRetiredArrays();                             // replaced arrays still waiting for readers to move on.
+};
+
+
+#endif
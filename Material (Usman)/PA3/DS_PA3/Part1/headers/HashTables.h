@@ -2,84 +2,303 @@
 #define HASHTABLE_H
 #include <iostream>
 #include <vector>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <cstdlib>
+#include <type_traits>
 using namespace std;
 
 enum CollisionHandle                                        // enumeration to help handle the collision handling strategies.
 {
     LINEAR_PROBING,
     QUADRATIC_PROBING,
-    SEPARATE_CHAINING
+    SEPARATE_CHAINING,
+    ROBIN_HOOD,                                             // linear probing that keeps probe distances even; no tombstones.
+    SWISS_TABLE,                                            // 16-slot groups screened by 7-bit hash tags with one SIMD compare.
+    CUCKOO                                                  // two candidate 4-slot buckets per key plus a small stash.
 };
 
-template <typename T>
+// =======================
+// Hashers
+// =======================
+// A hasher maps a key to 64 bits. The table keeps only the low bits (it is
+// always a power of two in size), so every bit of the key has to reach them.
+
+inline uint64_t hashMix64(uint64_t x)                      // multiply-xorshift finalizer: full avalanche in two multiplies.
+{
+    x ^= x >> 32;
+    x *= 0xd6e8feb86659fd93ULL;
+    x ^= x >> 32;
+    x *= 0xd6e8feb86659fd93ULL;
+    x ^= x >> 32;
+    return x;
+}
+
+inline uint64_t hashBytes(const char* data, size_t length)  // eight bytes per round, finalized with hashMix64.
+{
+    uint64_t h = 0x9e3779b97f4a7c15ULL ^ (length * 0xff51afd7ed558ccdULL);
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8)
+    {
+        uint64_t word;
+        memcpy(&word, data + i, 8);
+        h = (h ^ word) * 0x9e3779b97f4a7c15ULL;
+        h ^= h >> 29;
+    }
+    uint64_t tail = 0;
+    memcpy(&tail, data + i, length - i);
+    return hashMix64(h ^ tail);
+}
+
+template <typename K>
+struct StrongHash                                           // default: std::hash, then mixed so sequential or strided keys spread out.
+{
+    uint64_t operator()(const K& key) const {return hashMix64(static_cast<uint64_t>(std::hash<K>{}(key)));}
+};
+
+template <>
+struct StrongHash<string>
+{
+    uint64_t operator()(const string& key) const {return hashBytes(key.data(), key.size());}
+};
+
+template <typename K>
+struct IdentityHash                                         // std::hash as is (identity for integers): the old key % size behaviour.
+{
+    uint64_t operator()(const K& key) const {return static_cast<uint64_t>(std::hash<K>{}(key));}
+};
+
+// =======================
+// Telemetry
+// =======================
+// Snapshot returned by HashTable::getStats(). Histogram bucket n counts operations that inspected n
+// slots (groups for SWISS_TABLE, buckets for CUCKOO, chain entries for SEPARATE_CHAINING); the last
+// bucket also takes everything longer. The histograms only fill while instrumentation is switched on.
+struct HashTableStats
+{
+    static const int HISTOGRAM_BUCKETS = 32;
+
+    long long insertProbes[HISTOGRAM_BUCKETS] = {};
+    long long searchProbes[HISTOGRAM_BUCKETS] = {};
+    vector<long long> chainLengths;                         // SEPARATE_CHAINING: chainLengths[n] = buckets holding n entries.
+    int elements = 0;
+    int tableSize = 0;
+    int tombstones = 0;
+    int resizes = 0;                                        // times the table doubled, incremental migrations included.
+    int tombstonePurges = 0;                                // same-size rehashes.
+    double rehashMilliseconds = 0;                          // time spent rehashing and migrating.
+    long long slotsInitialized = 0;                         // slots filled in when allocating arrays; zero pages from calloc are free.
+    long long entriesMoved = 0;                             // entries re-inserted by rehashes and migration steps.
+};
+
+// T is the value type. K and Hasher default to int keys and StrongHash, so HashTable<T> keeps its old meaning.
+template <typename T, typename K = int, typename Hasher = StrongHash<K>>
 class HashTable
 {
     private:
+        static const int INITIAL_TABLE_SIZE = 16;           // table sizes are always powers of two.
+
         CollisionHandle collision_strategy;
-    
+        Hasher hasher;
+
         int table_size = 0;                                 // size of the hash table.
         int num_elements = 0;                               // number of elements in the hash table.
         float loadFactor = 0.0;
         float loadFactorThreshold = 0.85;
+        float robinHoodLoadFactorThreshold = 0.95;          // Robin Hood keeps probes short at much higher load.
+        float cuckooLoadFactorThreshold = 0.9;              // 4-way buckets keep eviction chains short up to here.
+        int num_tombstones = 0;                             // removed-key markers (SLOT_TOMBSTONE, or CONTROL_DELETED for SWISS_TABLE).
+        float tombstoneRatioThreshold = 0.2;                // purge in place once this share of the slots are tombstones.
+
+        enum SlotState : uint8_t
+        {
+            SLOT_EMPTY,                                     // never used since the last rehash; ends every probe chain.
+            SLOT_OCCUPIED,
+            SLOT_TOMBSTONE                                  // held a removed key; probes must walk past it.
+        };
 
         struct KeyValuePair
         {
-            int key;                                        // key used to hash the value.
+            K key;                                          // key used to hash the value.
             T value;                                        // value associated with the key.
-            bool isEmpty;                                   // flag to indicate if the slot is empty.
+            SlotState state;
+            int probeDistance;                              // ROBIN_HOOD: slots between the home slot and this one.
 
-            KeyValuePair() : key(0), value(T()), isEmpty(true) {}
-            KeyValuePair(int k, T v, bool empty) : key(k), value(v), isEmpty(empty) {}
+            KeyValuePair() : key(K()), value(T()), state(SLOT_EMPTY), probeDistance(0) {}
+            KeyValuePair(const K& k, const T& v) : key(k), value(v), state(SLOT_OCCUPIED), probeDistance(0) {}
+
+            bool isOccupied() const {return state == SLOT_OCCUPIED;}
 
             // overload equality operator for ease.
             bool operator==(const KeyValuePair &other) const
             {
-                return key == other.key && value == other.value && isEmpty == other.isEmpty;
+                return key == other.key && value == other.value && state == other.state;
             }
         };
 
         KeyValuePair* probing_table = nullptr;
 
-        vector<vector<KeyValuePair>> chaining_table;       // hash table for separate chaining (vector of vectors).
+        // With trivial K and T an all-zero slot is an empty one (SLOT_EMPTY is 0), so the array comes from
+        // calloc: a large block arrives as untouched zero pages and allocating it writes nothing.
+        static constexpr bool ZERO_FILLED_SLOTS = is_trivial<K>::value && is_trivial<T>::value;
+        KeyValuePair* newSlots(int size);
+        static void freeSlots(KeyValuePair* slots);
+
+        // SWISS_TABLE metadata, one byte per probing_table slot: CONTROL_EMPTY, CONTROL_DELETED or the
+        // low 7 bits of the key's hash with the high bit set. Slots form groups of GROUP_WIDTH that are
+        // matched in one step. Empty is 0, so the control bytes come from calloc too.
+        static const int GROUP_WIDTH = 16;
+        static const int8_t CONTROL_EMPTY = 0;
+        static const int8_t CONTROL_DELETED = 1;
+        int8_t* control_bytes = nullptr;
+        static int8_t swissTag(uint64_t hash) {return static_cast<int8_t>(0x80 | (hash & 0x7f));}
+
+        // CUCKOO: probing_table is read as buckets of CUCKOO_BUCKET_WIDTH slots. A key that cannot be
+        // placed within CUCKOO_MAX_KICKS evictions goes to the stash; a full stash forces a resize.
+        static const int CUCKOO_BUCKET_WIDTH = 4;
+        static const int CUCKOO_MAX_KICKS = 64;
+        static const size_t CUCKOO_STASH_SIZE = 4;
+        vector<KeyValuePair> cuckoo_stash;
+        uint32_t cuckoo_random = 0x9e3779b9;                // xorshift state for picking eviction victims.
 
-        int hashFunction1(int key){return key%table_size;};                         // primary hash function (used for all methods).
+        // SEPARATE_CHAINING: each bucket holds the pool index of its first entry, and entries link by index.
+        // All entries share one pool, and removed ones are kept on a free list for reuse, so a chain
+        // costs no allocation of its own and indices stay 32 bits.
+        static constexpr uint32_t CHAIN_END = UINT32_MAX;
+
+        struct ChainEntry
+        {
+            K key;
+            T value;
+            uint32_t next;                                  // pool index of the next entry in the chain (or free list).
+        };
+
+        vector<uint32_t> bucket_heads;
+        vector<ChainEntry> chain_pool;
+        uint32_t chain_free = CHAIN_END;                    // head of the free list threaded through chain_pool.
+
+        int hashFunction1(const K& key) const {return static_cast<int>(hasher(key) & static_cast<uint64_t>(table_size - 1));}  // primary hash function (used for all methods).
 
         void calculateLoadFactor();
 
+        bool instrumented = false;                          // fill the probe histograms in stats.
+        HashTableStats stats;                               // resize counts and rehash time are kept regardless.
+        int lookupProbes(const K& key) const;               // slots (groups, buckets, chain entries) a lookup for key inspects here.
+
+        // shared open-addressing helpers; quadratic probing steps by triangular numbers, which visit every slot of a power-of-two table.
+        int probeSlot(int home, int attempt) const;
+        int findProbingSlot(const K& key, uint64_t hash) const;         // index of the key's slot, or -1.
+        int probeLengthOf(int slot) const;                  // slots inspected to reach the key stored at slot.
+        bool insertProbing(const K& key, const T& value);   // true if the key was new.
+        bool removeProbing(const K& key);                   // true if the key was present.
+
         // methods for Linear Probing.
-        void insertLinearProbing(int key, T value);
-        T searchLinearProbing(int key);
-        void removeLinearProbing(int key);
+        bool insertLinearProbing(const K& key, const T& value);
+        T* searchLinearProbing(const K& key, uint64_t hash);               // nullptr if absent.
+        bool removeLinearProbing(const K& key);
 
         // methods for Quadratic Probing.
-        void insertQuadraticProbing(int key, T value);
-        T searchQuadraticProbing(int key);
-        void removeQuadraticProbing(int key);
+        bool insertQuadraticProbing(const K& key, const T& value);
+        T* searchQuadraticProbing(const K& key, uint64_t hash);
+        bool removeQuadraticProbing(const K& key);
+
+        // methods for Robin Hood hashing.
+        int findRobinHoodSlot(const K& key, uint64_t hash) const;       // index of the key's slot, or -1.
+        bool insertRobinHood(const K& key, const T& value);
+        T* searchRobinHood(const K& key, uint64_t hash);
+        bool removeRobinHood(const K& key);                 // backward-shift deletion.
+
+        // methods for Swiss table probing; groups are probed in triangular steps, like QUADRATIC_PROBING over slots.
+        int swissGroup(uint64_t hash, int attempt) const;
+        int findSwissSlot(const K& key, uint64_t hash) const;           // index of the key's slot, or -1.
+        bool insertSwissTable(const K& key, const T& value);
+        T* searchSwissTable(const K& key, uint64_t hash);
+        bool removeSwissTable(const K& key);
+
+        // methods for Cuckoo hashing.
+        void cuckooBuckets(uint64_t hash, int& first, int& second) const;
+        int findCuckooSlot(const K& key, uint64_t hash) const;          // index of the key's slot, or -1 (the stash is not searched).
+        bool insertCuckoo(const K& key, const T& value);
+        T* searchCuckoo(const K& key, uint64_t hash);
+        bool removeCuckoo(const K& key);
 
         // methods for Separate Chaining.
-        void insertSeparateChaining(int key, T value);
-        T searchSeparateChaining(int key);
-        void removeSeparateChaining(int key);
+        int chainLength(int bucket) const;
+        bool insertSeparateChaining(const K& key, const T& value);
+        T* searchSeparateChaining(const K& key, uint64_t hash);
+        bool removeSeparateChaining(const K& key);
 
+        // strategy dispatch on this table's own arrays; no counting, no load factor check.
+        bool insertInto(const K& key, const T& value);      // true if the key was new.
+        T* findIn(const K& key, uint64_t hash);             // hash is hasher(key), computed once by the caller.
+        bool removeFrom(const K& key);
+
+        void allocateTable(int size);
+        void rehash(int size);                              // re-insert the live entries into a fresh table of this size.
         void resizeAndRehash();
+        void purgeTombstones();                             // same-size rehash that drops every tombstone.
+
+        // incremental rehashing: the old arrays live in a draining table that is emptied a few buckets at a time.
+        bool incremental_rehash = false;
+        int rehash_step = 16;                               // old buckets migrated per insert/search/remove.
+        int migrate_cursor = 0;                             // next old bucket to migrate.
+        unique_ptr<HashTable> draining;
+
+        // batch operations: hash every key first, then touch each home slot prefetch_distance keys ahead of its probe.
+        int prefetch_distance = 8;
+        void prefetchHome(uint64_t hash) const;
+
+        void swapStorage(HashTable& other);
+        void startMigration();
+        void migrateBucket(int bucket);
+        void migrateStep();
+        void finishMigration();
 
     public:
-        HashTable(CollisionHandle strategy = LINEAR_PROBING);       // constructor to initialize the hash table and choose collision handling strategy.
+        HashTable(CollisionHandle strategy = LINEAR_PROBING, const Hasher& hash = Hasher());   // constructor to initialize the hash table and choose collision handling strategy.
 
         ~HashTable();                                               // destructor.
 
-        void insert(int key, T value);                              // insert a key-value pair based on the chosen collision handling strategy.
+        HashTable(const HashTable&) = delete;
+        HashTable& operator=(const HashTable&) = delete;
+
+        void insert(const K& key, T value);                         // insert a key-value pair (or update the value of an existing key).
+
+        T search(const K& key);                                     // search for a key and return its associated value, or T() if absent.
+
+        void remove(const K& key);                                  // remove a key-value pair based on the chosen strategy.
 
-        T search(int key);                                          // search for a key and return its associated value based on the chosen strategy.
+        void searchBatch(const vector<K>& keys, vector<T>& outValues);         // outValues[i] = search(keys[i]), with the cache misses overlapped.
 
-        void remove(int key);                                       // remove a key-value pair based on the chosen strategy.
+        void insertBatch(const vector<K>& keys, const vector<T>& values);      // insert(keys[i], values[i]) in order, prefetching ahead.
+
+        void setPrefetchDistance(int distance) {prefetch_distance = distance > 0 ? distance : 0;}
 
         void displayProbingTable();                                             // Please use this for debugging help
 
         int getTableSize() {return table_size;}                     // DO NOT MODIFY.
 
         int getNumberElements() {return num_elements;}              // DO NOT MODIFY.
+
+        int getNumberTombstones() {return num_tombstones;}          // removed-key markers still lengthening probe chains.
+
+        void setIncrementalRehash(bool enabled, int bucketsPerStep = 16);   // grow without a stop-the-world rehash.
+
+        bool isRehashing() const {return draining != nullptr;}     // an incremental migration is still in progress.
+
+        double averageProbeLength();                                // mean slots inspected to find each stored key (1.0 = every key in its home slot).
+
+        int maxProbeLength();                                       // slots inspected to find the worst-placed key.
+
+        void setInstrumentation(bool enabled) {instrumented = enabled;}   // probe histograms cost one extra walk per operation.
+
+        HashTableStats getStats();                                  // counters so far plus a snapshot of the table's shape.
+
+        void resetStats() {stats = HashTableStats();}
 };
 
 
-#endif
\ No newline at end of file
+#endif
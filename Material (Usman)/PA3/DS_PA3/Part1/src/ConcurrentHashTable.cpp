@@ -0,0 +1,317 @@
+#include "ConcurrentHashTable.h"
+#include <functional>
+#include <thread>
+
+
+// =======================
+// Constructor
+// =======================
+template <typename T, typename K, typename Hasher>
+ConcurrentHashTable<T, K, Hasher>::ConcurrentHashTable(const Hasher& hash) : hasher(hash)
+{
+    for (Stripe& stripe : stripes)
+        stripe.storage.store(new Storage(INITIAL_STRIPE_SIZE));
+}
+
+// =======================
+// Destructor
+// =======================
+template <typename T, typename K, typename Hasher>
+ConcurrentHashTable<T, K, Hasher>::~ConcurrentHashTable()
+{
+    for (Stripe& stripe : stripes)
+        delete stripe.storage.load();
+}
+
+// =======================
+// Slot Versions
+// =======================
+// Writers to one stripe are serialised by its lock, so the version needs no
+// read-modify-write: odd from beginWrite to endWrite, even otherwise.
+template <typename T, typename K, typename Hasher>
+void ConcurrentHashTable<T, K, Hasher>::beginWrite(Slot& slot)
+{
+    slot.version.store(slot.version.load(memory_order_relaxed) + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+template <typename T, typename K, typename Hasher>
+void ConcurrentHashTable<T, K, Hasher>::endWrite(Slot& slot)
+{
+    slot.version.store(slot.version.load(memory_order_relaxed) + 1, memory_order_release);
+}
+
+template <typename T, typename K, typename Hasher>
+bool ConcurrentHashTable<T, K, Hasher>::readSlot(const Slot& slot, SlotState& state, K& key, T& value) const
+{
+    uint32_t before = slot.version.load(memory_order_acquire);
+    if (before & 1)
+        return false;
+    state = slot.state.load(memory_order_relaxed);
+    key = slot.key.load(memory_order_relaxed);
+    value = slot.value.load(memory_order_relaxed);
+    atomic_thread_fence(memory_order_acquire);
+    return slot.version.load(memory_order_relaxed) == before;
+}
+
+// =======================
+// Storage
+// =======================
+template <typename T, typename K, typename Hasher>
+int ConcurrentHashTable<T, K, Hasher>::findSlot(const Storage& storage, uint64_t hash, const K& key) const
+{
+    int mask = storage.size - 1;
+    int slot = static_cast<int>(hash & static_cast<uint64_t>(mask));
+    for (int attempt = 0; attempt < storage.size; attempt++)
+    {
+        const Slot& entry = storage.slots[slot];
+        SlotState state = entry.state.load(memory_order_relaxed);
+        if (state == SLOT_EMPTY)
+            return -1;
+        if (state == SLOT_OCCUPIED && entry.key.load(memory_order_relaxed) == key)
+            return slot;
+        slot = (slot + 1) & mask;
+    }
+    return -1;
+}
+
+template <typename T, typename K, typename Hasher>
+void ConcurrentHashTable<T, K, Hasher>::rehashStripe(Stripe& stripe, int size)
+{
+    // The new array is private until it is published, so it is filled without versioning.
+    Storage* old = stripe.storage.load(memory_order_relaxed);
+    Storage* fresh = new Storage(size);
+    int mask = size - 1;
+    for (int i = 0; i < old->size; i++)
+    {
+        const Slot& entry = old->slots[i];
+        if (entry.state.load(memory_order_relaxed) != SLOT_OCCUPIED)
+            continue;
+        K key = entry.key.load(memory_order_relaxed);
+        int slot = static_cast<int>(hasher(key) & static_cast<uint64_t>(mask));
+        while (fresh->slots[slot].state.load(memory_order_relaxed) != SLOT_EMPTY)
+            slot = (slot + 1) & mask;
+        fresh->slots[slot].state.store(SLOT_OCCUPIED, memory_order_relaxed);
+        fresh->slots[slot].key.store(key, memory_order_relaxed);
+        fresh->slots[slot].value.store(entry.value.load(memory_order_relaxed), memory_order_relaxed);
+    }
+    stripe.storage.store(fresh, memory_order_seq_cst);
+    // Readers pinned at or before this epoch may have loaded the old array.
+    stripe.retired.emplace_back(globalEpoch.fetch_add(1, memory_order_seq_cst), unique_ptr<Storage>(old));
+    stripe.num_tombstones = 0;
+}
+
+// =======================
+// Reclamation
+// =======================
+template <typename T, typename K, typename Hasher>
+int ConcurrentHashTable<T, K, Hasher>::pinReader()
+{
+    // Start at a per-thread offset, so threads rarely collide on a slot.
+    int start = static_cast<int>(hash<thread::id>()(this_thread::get_id()) % MAX_READERS);
+    for (int attempt = 0;; attempt++)
+    {
+        int slot = (start + attempt) % MAX_READERS;
+        bool expected = false;
+        if (!readers[slot].claimed.load(memory_order_relaxed) &&
+            readers[slot].claimed.compare_exchange_strong(expected, true, memory_order_acquire))
+        {
+            // seq_cst: the pin must be visible before the reader loads a storage pointer.
+            readers[slot].epoch.store(globalEpoch.load(memory_order_seq_cst), memory_order_seq_cst);
+            return slot;
+        }
+        if (attempt % MAX_READERS == MAX_READERS - 1)
+            this_thread::yield();
+    }
+}
+
+template <typename T, typename K, typename Hasher>
+void ConcurrentHashTable<T, K, Hasher>::unpinReader(int slot)
+{
+    readers[slot].epoch.store(IDLE, memory_order_release);
+    readers[slot].claimed.store(false, memory_order_release);
+}
+
+template <typename T, typename K, typename Hasher>
+uint64_t ConcurrentHashTable<T, K, Hasher>::oldestPinnedEpoch() const
+{
+    uint64_t oldest = UINT64_MAX;
+    for (const ReaderSlot& reader : readers)
+    {
+        uint64_t epoch = reader.epoch.load(memory_order_seq_cst);
+        if (epoch != IDLE && epoch < oldest)
+            oldest = epoch;
+    }
+    return oldest;
+}
+
+template <typename T, typename K, typename Hasher>
+void ConcurrentHashTable<T, K, Hasher>::reclaim(Stripe& stripe)
+{
+    // A reader pins before it loads the storage pointer, so one that could still hold an array
+    // retired at epoch e pinned an epoch <= e. Arrays older than every pin are unreachable.
+    if (stripe.retired.empty())
+        return;
+    uint64_t oldest = oldestPinnedEpoch();
+    size_t kept = 0;
+    for (auto& entry : stripe.retired)
+        if (entry.first >= oldest)
+            stripe.retired[kept++] = move(entry);
+    stripe.retired.resize(kept);
+}
+
+template <typename T, typename K, typename Hasher>
+void ConcurrentHashTable<T, K, Hasher>::checkLoad(Stripe& stripe)
+{
+    int size = stripe.storage.load(memory_order_relaxed)->size;
+    int elements = stripe.num_elements.load(memory_order_relaxed);
+    int tombstones = stripe.num_tombstones;
+    if (tombstones <= tombstoneRatioThreshold * size && elements + tombstones <= loadFactorThreshold * size)
+        return;
+    // Same rule as HashTable: a same-size rebuild only when it frees a real share of the array, else grow.
+    if (elements <= loadFactorThreshold * size && tombstones >= tombstoneRatioThreshold / 2 * size)
+        rehashStripe(stripe, size);
+    else
+        rehashStripe(stripe, size * 2);
+}
+
+// =======================
+// Insert
+// =======================
+template <typename T, typename K, typename Hasher>
+void ConcurrentHashTable<T, K, Hasher>::insert(const K& key, T value)
+{
+    uint64_t hash = hasher(key);
+    Stripe& stripe = stripeOf(hash);
+    lock_guard<mutex> guard(stripe.writeLock);
+    Storage& storage = *stripe.storage.load(memory_order_relaxed);
+    int mask = storage.size - 1;
+    int slot = static_cast<int>(hash & static_cast<uint64_t>(mask));
+    int reusable = -1;                                      // first tombstone on the path, else the empty slot that ends it.
+    for (int attempt = 0; attempt < storage.size; attempt++)
+    {
+        Slot& entry = storage.slots[slot];
+        SlotState state = entry.state.load(memory_order_relaxed);
+        if (state == SLOT_OCCUPIED && entry.key.load(memory_order_relaxed) == key)
+        {
+            beginWrite(entry);
+            entry.value.store(value, memory_order_relaxed);
+            endWrite(entry);
+            return;
+        }
+        if (state != SLOT_OCCUPIED && reusable < 0)
+            reusable = slot;
+        if (state == SLOT_EMPTY)
+            break;
+        slot = (slot + 1) & mask;
+    }
+    // checkLoad keeps elements plus tombstones under the threshold, so the probe always found a free slot.
+    Slot& target = storage.slots[reusable];
+    if (target.state.load(memory_order_relaxed) == SLOT_TOMBSTONE)
+        stripe.num_tombstones--;
+    beginWrite(target);
+    target.key.store(key, memory_order_relaxed);
+    target.value.store(value, memory_order_relaxed);
+    target.state.store(SLOT_OCCUPIED, memory_order_relaxed);
+    endWrite(target);
+    stripe.num_elements.fetch_add(1, memory_order_relaxed);
+    checkLoad(stripe);
+    reclaim(stripe);
+}
+
+// =======================
+// Search
+// =======================
+template <typename T, typename K, typename Hasher>
+T ConcurrentHashTable<T, K, Hasher>::search(const K& key)
+{
+    uint64_t hash = hasher(key);
+    Stripe& stripe = stripeOf(hash);
+    int reader = pinReader();
+    const Storage& storage = *stripe.storage.load(memory_order_seq_cst);
+    T result = T();
+    int mask = storage.size - 1;
+    int slot = static_cast<int>(hash & static_cast<uint64_t>(mask));
+    for (int attempt = 0; attempt < storage.size;)
+    {
+        SlotState state;
+        K seenKey;
+        T seenValue;
+        if (!readSlot(storage.slots[slot], state, seenKey, seenValue))
+            continue;                                       // a writer was in this slot; read it again.
+        if (state == SLOT_EMPTY)
+            break;
+        if (state == SLOT_OCCUPIED && seenKey == key)
+        {
+            result = seenValue;
+            break;
+        }
+        slot = (slot + 1) & mask;
+        attempt++;
+    }
+    unpinReader(reader);
+    return result;
+}
+
+// =======================
+// Remove
+// =======================
+template <typename T, typename K, typename Hasher>
+void ConcurrentHashTable<T, K, Hasher>::remove(const K& key)
+{
+    uint64_t hash = hasher(key);
+    Stripe& stripe = stripeOf(hash);
+    lock_guard<mutex> guard(stripe.writeLock);
+    Storage& storage = *stripe.storage.load(memory_order_relaxed);
+    int slot = findSlot(storage, hash, key);
+    if (slot < 0)
+        return;
+    // A tombstone rather than an empty slot: a reader may be walking past it towards a later key.
+    Slot& entry = storage.slots[slot];
+    beginWrite(entry);
+    entry.state.store(SLOT_TOMBSTONE, memory_order_relaxed);
+    endWrite(entry);
+    stripe.num_elements.fetch_sub(1, memory_order_relaxed);
+    stripe.num_tombstones++;
+    checkLoad(stripe);
+    reclaim(stripe);
+}
+
+// =======================
+// Diagnostics
+// =======================
+template <typename T, typename K, typename Hasher>
+int ConcurrentHashTable<T, K, Hasher>::getTableSize()
+{
+    int total = 0;
+    for (Stripe& stripe : stripes)
+    {
+        lock_guard<mutex> guard(stripe.writeLock);
+        total += stripe.storage.load(memory_order_relaxed)->size;
+    }
+    return total;
+}
+
+template <typename T, typename K, typename Hasher>
+int ConcurrentHashTable<T, K, Hasher>::getNumberElements()
+{
+    int total = 0;
+    for (Stripe& stripe : stripes)
+        total += stripe.num_elements.load(memory_order_relaxed);
+    return total;
+}
+
+template <typename T, typename K, typename Hasher>
+int ConcurrentHashTable<T, K, Hasher>::getRetiredArrays()
+{
+    int total = 0;
+    for (Stripe& stripe : stripes)
+    {
+        lock_guard<mutex> guard(stripe.writeLock);
+        total += static_cast<int>(stripe.retired.size());
+    }
+    return total;
+}
+
+template class ConcurrentHashTable<int>;
+template class ConcurrentHashTable<long long>;
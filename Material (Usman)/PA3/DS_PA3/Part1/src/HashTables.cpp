@@ -1,167 +1,1162 @@
 #include "HashTables.h"
+#include <chrono>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Bit i is set when byte i of the 16-byte group equals tag.
+static inline uint32_t matchGroup(const int8_t* group, int8_t tag)
+{
+#if defined(__SSE2__)
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(tag))));
+#else
+    uint32_t mask = 0;
+    for (int i = 0; i < 16; i++)
+        if (group[i] == tag)
+            mask |= 1u << i;
+    return mask;
+#endif
+}
 
 
 // =======================
 // Constructor
 // =======================
-template <typename T>
-HashTable<T>::HashTable(CollisionHandle strategy)
+template <typename T, typename K, typename Hasher>
+HashTable<T, K, Hasher>::HashTable(CollisionHandle strategy, const Hasher& hash) : hasher(hash)
 {
     collision_strategy = strategy;
+    allocateTable(INITIAL_TABLE_SIZE);
 }
 
 // =======================
 // Destructor
 // =======================
-template <typename T>
-HashTable<T>::~HashTable()
+template <typename T, typename K, typename Hasher>
+HashTable<T, K, Hasher>::~HashTable()
 {
+    freeSlots(probing_table);
+    free(control_bytes);
+}
 
+// =======================
+// Storage
+// =======================
+template <typename T, typename K, typename Hasher>
+typename HashTable<T, K, Hasher>::KeyValuePair* HashTable<T, K, Hasher>::newSlots(int size)
+{
+    static_assert(SLOT_EMPTY == 0, "calloc'd slots must read as empty");
+    if (!ZERO_FILLED_SLOTS)
+    {
+        stats.slotsInitialized += size;
+        return new KeyValuePair[size];
+    }
+    void* slots = calloc(size, sizeof(KeyValuePair));
+    if (!slots)
+        throw bad_alloc();
+    return static_cast<KeyValuePair*>(slots);
+}
+
+template <typename T, typename K, typename Hasher>
+void HashTable<T, K, Hasher>::freeSlots(KeyValuePair* slots)
+{
+    if (ZERO_FILLED_SLOTS)
+        free(slots);
+    else
+        delete[] slots;
+}
+
+template <typename T, typename K, typename Hasher>
+void HashTable<T, K, Hasher>::allocateTable(int size)
+{
+    freeSlots(probing_table);
+    free(control_bytes);
+    probing_table = nullptr;
+    control_bytes = nullptr;
+    bucket_heads.clear();
+    chain_pool.clear();
+    chain_free = CHAIN_END;
+    cuckoo_stash.clear();
+    table_size = size;
+    num_tombstones = 0;
+    if (collision_strategy == SEPARATE_CHAINING)
+    {
+        bucket_heads.assign(size, CHAIN_END);
+        stats.slotsInitialized += size;
+    }
+    else
+        probing_table = newSlots(size);
+    if (collision_strategy == SWISS_TABLE)
+    {
+        control_bytes = static_cast<int8_t*>(calloc(size, 1));
+        if (!control_bytes)
+            throw bad_alloc();
+    }
 }
 
 // =======================
 // Load Factor Calculation
 // =======================
-template <typename T>
-void HashTable<T>::calculateLoadFactor()
+template <typename T, typename K, typename Hasher>
+void HashTable<T, K, Hasher>::calculateLoadFactor()
+{
+    loadFactor = static_cast<float>(num_elements) / table_size;
+    float threshold = loadFactorThreshold;
+    if (collision_strategy == ROBIN_HOOD)
+        threshold = robinHoodLoadFactorThreshold;
+    else if (collision_strategy == CUCKOO)
+        threshold = cuckooLoadFactorThreshold;
+    if (loadFactor <= threshold)
+    {
+        // Tombstones do not count as elements but still fill probe paths, so a delete-heavy table
+        // would otherwise never rehash and its misses would walk ever longer chains.
+        if (num_tombstones <= tombstoneRatioThreshold * table_size &&
+            num_elements + num_tombstones <= threshold * table_size)
+            return;
+        // A same-size purge only pays off when it frees a real share of the table. With just a
+        // few tombstones, churn at the threshold would purge again a few inserts later, so the
+        // table grows instead. Either way at least tombstoneRatioThreshold / 2 * table_size
+        // removals separate two rehashes at one size, so each O(table_size) rehash is amortised.
+        if (num_tombstones >= tombstoneRatioThreshold / 2 * table_size)
+        {
+            purgeTombstones();
+            return;
+        }
+    }
+    if (!incremental_rehash)
+    {
+        resizeAndRehash();
+        return;
+    }
+    // Reached when the step size is too small to keep up with inserts, or tombstones crowd the table.
+    if (draining)
+        finishMigration();
+    startMigration();
+}
+
+template <typename T, typename K, typename Hasher>
+void HashTable<T, K, Hasher>::rehash(int size)
 {
-    
+    // Move the live entries out, reallocate and re-insert; tombstones are dropped.
+    auto start = chrono::steady_clock::now();
+    (size > table_size ? stats.resizes : stats.tombstonePurges)++;
+    vector<KeyValuePair> entries;
+    entries.reserve(num_elements);
+    if (collision_strategy == SEPARATE_CHAINING)
+    {
+        for (uint32_t head : bucket_heads)
+            for (uint32_t i = head; i != CHAIN_END; i = chain_pool[i].next)
+                entries.emplace_back(chain_pool[i].key, move(chain_pool[i].value));
+    }
+    else
+    {
+        for (int i = 0; i < table_size; i++)
+            if (probing_table[i].isOccupied())
+                entries.push_back(move(probing_table[i]));
+        for (auto& entry : cuckoo_stash)
+            entries.push_back(move(entry));
+    }
+
+    allocateTable(size);
+    for (auto& entry : entries)
+        insertInto(entry.key, entry.value);
+    stats.entriesMoved += entries.size();
+    loadFactor = static_cast<float>(num_elements) / table_size;
+    stats.rehashMilliseconds += chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
 }
 
+template <typename T, typename K, typename Hasher>
+void HashTable<T, K, Hasher>::resizeAndRehash()
+{
+    rehash(table_size * 2);
+}
+
+template <typename T, typename K, typename Hasher>
+void HashTable<T, K, Hasher>::purgeTombstones()
+{
+    rehash(table_size);
+}
 
 // =======================
-// Linear Probing Methods
+// Incremental Rehashing
+// =======================
+// Instead of moving everything at once, the full arrays are handed to a
+// draining table and this table starts over at twice the size. Every public
+// operation then migrates up to rehash_step of the old buckets. A key is in
+// exactly one of the two tables at any time, so lookups try the new table and
+// then the old one.
+template <typename T, typename K, typename Hasher>
+void HashTable<T, K, Hasher>::setIncrementalRehash(bool enabled, int bucketsPerStep)
+{
+    if (!enabled && draining)
+        finishMigration();
+    incremental_rehash = enabled;
+    rehash_step = bucketsPerStep > 0 ? bucketsPerStep : 1;
+}
+
+template <typename T, typename K, typename Hasher>
+void HashTable<T, K, Hasher>::swapStorage(HashTable& other)
+{
+    swap(probing_table, other.probing_table);
+    swap(control_bytes, other.control_bytes);
+    swap(bucket_heads, other.bucket_heads);
+    swap(chain_pool, other.chain_pool);
+    swap(chain_free, other.chain_free);
+    swap(cuckoo_stash, other.cuckoo_stash);
+    swap(table_size, other.table_size);
+    swap(num_tombstones, other.num_tombstones);
+}
+
+template <typename T, typename K, typename Hasher>
+void HashTable<T, K, Hasher>::startMigration()
+{
+    auto start = chrono::steady_clock::now();
+    stats.resizes++;
+    draining.reset(new HashTable(collision_strategy, hasher));
+    swapStorage(*draining);
+    allocateTable(draining->table_size * 2);
+    migrate_cursor = 0;
+    // The bucket walk never reaches CUCKOO's stash, so its few entries move over right away.
+    for (auto& entry : draining->cuckoo_stash)
+        insertInto(entry.key, entry.value);
+    stats.entriesMoved += draining->cuckoo_stash.size();
+    draining->cuckoo_stash.clear();
+    loadFactor = static_cast<float>(num_elements) / table_size;
+    stats.rehashMilliseconds += chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+template <typename T, typename K, typename Hasher>
+void HashTable<T, K, Hasher>::migrateBucket(int bucket)
+{
+    HashTable& old = *draining;
+    // Removing through the old table's own strategy keeps its remaining probe chains valid.
+    // Robin Hood's backward shift can pull the next entry into this slot, hence the loop.
+    while (true)
+    {
+        K key;
+        T value;
+        if (collision_strategy == SEPARATE_CHAINING)
+        {
+            uint32_t head = old.bucket_heads[bucket];
+            if (head == CHAIN_END)
+                return;
+            key = old.chain_pool[head].key;
+            value = move(old.chain_pool[head].value);
+        }
+        else
+        {
+            if (!old.probing_table[bucket].isOccupied())
+                return;
+            key = old.probing_table[bucket].key;
+            value = move(old.probing_table[bucket].value);
+        }
+        old.removeFrom(key);
+        insertInto(key, value);
+        stats.entriesMoved++;
+    }
+}
+
+template <typename T, typename K, typename Hasher>
+void HashTable<T, K, Hasher>::migrateStep()
+{
+    if (!draining)
+        return;
+    auto start = chrono::steady_clock::now();
+    for (int moved = 0; moved < rehash_step && migrate_cursor < draining->table_size; moved++)
+        migrateBucket(migrate_cursor++);
+    if (migrate_cursor == draining->table_size)
+        draining.reset();
+    stats.rehashMilliseconds += chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+template <typename T, typename K, typename Hasher>
+void HashTable<T, K, Hasher>::finishMigration()
+{
+    while (draining)
+        migrateStep();
+}
+
 // =======================
-template <typename T>
-void HashTable<T>::insertLinearProbing(int key, T value)
+// Open Addressing Helpers
+// =======================
+template <typename T, typename K, typename Hasher>
+int HashTable<T, K, Hasher>::probeSlot(int home, int attempt) const
+{
+    int offset = collision_strategy == QUADRATIC_PROBING ? attempt * (attempt + 1) / 2 : attempt;
+    return (home + offset) & (table_size - 1);
+}
+
+template <typename T, typename K, typename Hasher>
+int HashTable<T, K, Hasher>::findProbingSlot(const K& key, uint64_t hash) const
+{
+    int home = static_cast<int>(hash & static_cast<uint64_t>(table_size - 1));
+    for (int attempt = 0; attempt < table_size; attempt++)
+    {
+        int slot = probeSlot(home, attempt);
+        const KeyValuePair& entry = probing_table[slot];
+        if (entry.state == SLOT_EMPTY)
+            return -1;
+        if (entry.isOccupied() && entry.key == key)
+            return slot;
+    }
+    return -1;
+}
+
+template <typename T, typename K, typename Hasher>
+bool HashTable<T, K, Hasher>::insertProbing(const K& key, const T& value)
 {
+    int home = hashFunction1(key);
+    int reusable = -1;                                      // first tombstone on the path.
+    for (int attempt = 0; attempt < table_size; attempt++)
+    {
+        int slot = probeSlot(home, attempt);
+        KeyValuePair& entry = probing_table[slot];
+        if (entry.isOccupied())
+        {
+            if (entry.key == key)
+            {
+                entry.value = value;
+                return false;
+            }
+            continue;
+        }
+        if (entry.state == SLOT_TOMBSTONE)
+        {
+            if (reusable < 0)
+                reusable = slot;
+            continue;
+        }
+        // A truly empty slot ends the chain, so the key is not stored further on.
+        if (reusable < 0)
+            reusable = slot;
+        break;
+    }
+    if (reusable < 0)
+    {
+        // Every slot on the probe path is occupied; grow and retry.
+        resizeAndRehash();
+        return insertProbing(key, value);
+    }
+    if (probing_table[reusable].state == SLOT_TOMBSTONE)
+        num_tombstones--;
+    probing_table[reusable] = KeyValuePair(key, value);
+    return true;
+}
 
+template <typename T, typename K, typename Hasher>
+bool HashTable<T, K, Hasher>::removeProbing(const K& key)
+{
+    int slot = findProbingSlot(key, hasher(key));
+    if (slot < 0)
+        return false;
+    probing_table[slot] = KeyValuePair();
+    probing_table[slot].state = SLOT_TOMBSTONE;
+    num_tombstones++;
+    return true;
 }
 
-template <typename T>
-T HashTable<T>::searchLinearProbing(int key)
+// =======================
+// Linear Probing Methods
+// =======================
+template <typename T, typename K, typename Hasher>
+bool HashTable<T, K, Hasher>::insertLinearProbing(const K& key, const T& value)
+{
+    return insertProbing(key, value);
+}
+
+template <typename T, typename K, typename Hasher>
+T* HashTable<T, K, Hasher>::searchLinearProbing(const K& key, uint64_t hash)
 {
-    return T();
+    int slot = findProbingSlot(key, hash);
+    return slot < 0 ? nullptr : &probing_table[slot].value;
 }
 
-template <typename T>
-void HashTable<T>::removeLinearProbing(int key)
+template <typename T, typename K, typename Hasher>
+bool HashTable<T, K, Hasher>::removeLinearProbing(const K& key)
 {
-    
+    return removeProbing(key);
 }
 
 // =======================
 // Quadratic Probing Methods
 // =======================
-template <typename T>
-void HashTable<T>::insertQuadraticProbing(int key, T value)
+template <typename T, typename K, typename Hasher>
+bool HashTable<T, K, Hasher>::insertQuadraticProbing(const K& key, const T& value)
 {
-    
+    return insertProbing(key, value);
 }
 
-template <typename T>
-T HashTable<T>::searchQuadraticProbing(int key)
+template <typename T, typename K, typename Hasher>
+T* HashTable<T, K, Hasher>::searchQuadraticProbing(const K& key, uint64_t hash)
 {
-    return T();
+    int slot = findProbingSlot(key, hash);
+    return slot < 0 ? nullptr : &probing_table[slot].value;
 }
 
-template <typename T>
-void HashTable<T>::removeQuadraticProbing(int key)
+template <typename T, typename K, typename Hasher>
+bool HashTable<T, K, Hasher>::removeQuadraticProbing(const K& key)
 {
-    
+    return removeProbing(key);
+}
+
+// =======================
+// Robin Hood Methods
+// =======================
+// Linear probing where an entry being placed takes the slot of any resident
+// that sits closer to its own home. Distances stay within a few slots of the
+// mean, so a search can stop as soon as it meets an entry nearer home than
+// the key would be.
+template <typename T, typename K, typename Hasher>
+bool HashTable<T, K, Hasher>::insertRobinHood(const K& key, const T& value)
+{
+    int mask = table_size - 1;
+    int slot = hashFunction1(key);
+    int distance = 0;
+    // Phase 1: look for the key up to the point where it would have been placed.
+    while (probing_table[slot].isOccupied() && probing_table[slot].probeDistance >= distance)
+    {
+        if (probing_table[slot].key == key)
+        {
+            probing_table[slot].value = value;
+            return false;
+        }
+        slot = (slot + 1) & mask;
+        distance++;
+    }
+    // Phase 2: place it, carrying each displaced resident on to the next slot.
+    KeyValuePair carried(key, value);
+    carried.probeDistance = distance;
+    while (probing_table[slot].isOccupied())
+    {
+        if (probing_table[slot].probeDistance < carried.probeDistance)
+            swap(carried, probing_table[slot]);
+        slot = (slot + 1) & mask;
+        carried.probeDistance++;
+        if (carried.probeDistance >= table_size)
+        {
+            // Cannot happen below the load threshold; grow rather than loop.
+            resizeAndRehash();
+            return insertRobinHood(carried.key, carried.value);
+        }
+    }
+    probing_table[slot] = move(carried);
+    return true;
+}
+
+template <typename T, typename K, typename Hasher>
+int HashTable<T, K, Hasher>::findRobinHoodSlot(const K& key, uint64_t hash) const
+{
+    int mask = table_size - 1;
+    int slot = static_cast<int>(hash & static_cast<uint64_t>(mask));
+    for (int distance = 0; probing_table[slot].isOccupied() && probing_table[slot].probeDistance >= distance; distance++)
+    {
+        if (probing_table[slot].key == key)
+            return slot;
+        slot = (slot + 1) & mask;
+    }
+    return -1;
+}
+
+template <typename T, typename K, typename Hasher>
+T* HashTable<T, K, Hasher>::searchRobinHood(const K& key, uint64_t hash)
+{
+    int slot = findRobinHoodSlot(key, hash);
+    return slot < 0 ? nullptr : &probing_table[slot].value;
+}
+
+template <typename T, typename K, typename Hasher>
+bool HashTable<T, K, Hasher>::removeRobinHood(const K& key)
+{
+    int slot = findRobinHoodSlot(key, hasher(key));
+    if (slot < 0)
+        return false;
+    int mask = table_size - 1;
+    // Pull the rest of the cluster back one slot until an entry is already home (or the slot is empty).
+    int next = (slot + 1) & mask;
+    while (probing_table[next].isOccupied() && probing_table[next].probeDistance > 0)
+    {
+        probing_table[slot] = move(probing_table[next]);
+        probing_table[slot].probeDistance--;
+        slot = next;
+        next = (next + 1) & mask;
+    }
+    probing_table[slot] = KeyValuePair();
+    return true;
+}
+
+// =======================
+// Swiss Table Methods
+// =======================
+// The high hash bits pick the first group, the low 7 bits are the tag kept in
+// control_bytes. A lookup compares the tag against a whole group of control
+// bytes at once and only reads the slots that match, so a miss usually costs
+// one 16-byte load. Probing stops at the first group that still has an empty
+// slot: the key would have been placed there.
+template <typename T, typename K, typename Hasher>
+int HashTable<T, K, Hasher>::swissGroup(uint64_t hash, int attempt) const
+{
+    int groups = table_size / GROUP_WIDTH;
+    return static_cast<int>(((hash >> 7) + static_cast<uint64_t>(attempt) * (attempt + 1) / 2) & static_cast<uint64_t>(groups - 1));
+}
+
+template <typename T, typename K, typename Hasher>
+int HashTable<T, K, Hasher>::findSwissSlot(const K& key, uint64_t hash) const
+{
+    int8_t tag = swissTag(hash);
+    int groups = table_size / GROUP_WIDTH;
+    for (int attempt = 0; attempt < groups; attempt++)
+    {
+        int base = swissGroup(hash, attempt) * GROUP_WIDTH;
+        for (uint32_t match = matchGroup(control_bytes + base, tag); match; match &= match - 1)
+        {
+            int slot = base + __builtin_ctz(match);
+            if (probing_table[slot].key == key)
+                return slot;
+        }
+        if (matchGroup(control_bytes + base, CONTROL_EMPTY))
+            return -1;
+    }
+    return -1;
+}
+
+template <typename T, typename K, typename Hasher>
+bool HashTable<T, K, Hasher>::insertSwissTable(const K& key, const T& value)
+{
+    uint64_t hash = hasher(key);
+    int existing = findSwissSlot(key, hash);
+    if (existing >= 0)
+    {
+        probing_table[existing].value = value;
+        return false;
+    }
+    int groups = table_size / GROUP_WIDTH;
+    for (int attempt = 0; attempt < groups; attempt++)
+    {
+        int base = swissGroup(hash, attempt) * GROUP_WIDTH;
+        uint32_t free = matchGroup(control_bytes + base, CONTROL_EMPTY) | matchGroup(control_bytes + base, CONTROL_DELETED);
+        if (free)
+        {
+            int slot = base + __builtin_ctz(free);
+            if (control_bytes[slot] == CONTROL_DELETED)
+                num_tombstones--;
+            control_bytes[slot] = swissTag(hash);
+            probing_table[slot] = KeyValuePair(key, value);
+            return true;
+        }
+    }
+    resizeAndRehash();
+    return insertSwissTable(key, value);
+}
+
+template <typename T, typename K, typename Hasher>
+T* HashTable<T, K, Hasher>::searchSwissTable(const K& key, uint64_t hash)
+{
+    int slot = findSwissSlot(key, hash);
+    return slot < 0 ? nullptr : &probing_table[slot].value;
+}
+
+template <typename T, typename K, typename Hasher>
+bool HashTable<T, K, Hasher>::removeSwissTable(const K& key)
+{
+    int slot = findSwissSlot(key, hasher(key));
+    if (slot < 0)
+        return false;
+    // A group that already has an empty slot ends every probe that reaches it, so the slot can simply
+    // become empty. In a full group a later key may have probed past it, so it has to stay marked.
+    int base = slot - slot % GROUP_WIDTH;
+    bool groupHadEmpty = matchGroup(control_bytes + base, CONTROL_EMPTY) != 0;
+    control_bytes[slot] = groupHadEmpty ? CONTROL_EMPTY : CONTROL_DELETED;
+    num_tombstones += groupHadEmpty ? 0 : 1;
+    probing_table[slot] = KeyValuePair();
+    return true;
+}
+
+// =======================
+// Cuckoo Methods
+// =======================
+// Every key has two candidate buckets of CUCKOO_BUCKET_WIDTH slots and is
+// always in one of them (or, rarely, in the stash), so a lookup reads at most
+// two buckets whatever the load. Inserting into two full buckets evicts a
+// resident to its other bucket, which may evict another, and so on.
+template <typename T, typename K, typename Hasher>
+void HashTable<T, K, Hasher>::cuckooBuckets(uint64_t hash, int& first, int& second) const
+{
+    // The first bucket holds the slot hashFunction1 would pick; the second comes from remixing the same hash.
+    uint64_t buckets = static_cast<uint64_t>(table_size / CUCKOO_BUCKET_WIDTH);
+    first = static_cast<int>((hash & static_cast<uint64_t>(table_size - 1)) / CUCKOO_BUCKET_WIDTH);
+    second = static_cast<int>(hashMix64(hash ^ 0x9e3779b97f4a7c15ULL) & (buckets - 1));
+}
+
+template <typename T, typename K, typename Hasher>
+int HashTable<T, K, Hasher>::findCuckooSlot(const K& key, uint64_t hash) const
+{
+    int first, second;
+    cuckooBuckets(hash, first, second);
+    for (int bucket : {first, second})
+    {
+        int base = bucket * CUCKOO_BUCKET_WIDTH;
+        for (int i = 0; i < CUCKOO_BUCKET_WIDTH; i++)
+            if (probing_table[base + i].isOccupied() && probing_table[base + i].key == key)
+                return base + i;
+    }
+    return -1;
+}
+
+template <typename T, typename K, typename Hasher>
+bool HashTable<T, K, Hasher>::insertCuckoo(const K& key, const T& value)
+{
+    if (T* existing = searchCuckoo(key, hasher(key)))
+    {
+        *existing = value;
+        return false;
+    }
+    KeyValuePair carried(key, value);
+    int evictedFrom = -1;                                   // bucket the carried entry was just pushed out of.
+    for (int kick = 0; kick < CUCKOO_MAX_KICKS; kick++)
+    {
+        int first, second;
+        cuckooBuckets(hasher(carried.key), first, second);
+        for (int bucket : {first, second})
+        {
+            int base = bucket * CUCKOO_BUCKET_WIDTH;
+            for (int i = 0; i < CUCKOO_BUCKET_WIDTH; i++)
+            {
+                if (!probing_table[base + i].isOccupied())
+                {
+                    probing_table[base + i] = move(carried);
+                    return true;
+                }
+            }
+        }
+        // Both buckets are full: push a random resident out of the bucket the carried entry did not just leave.
+        cuckoo_random ^= cuckoo_random << 13;
+        cuckoo_random ^= cuckoo_random >> 17;
+        cuckoo_random ^= cuckoo_random << 5;
+        int bucket = first == evictedFrom ? second : (second == evictedFrom ? first : (cuckoo_random & 1 ? second : first));
+        int slot = bucket * CUCKOO_BUCKET_WIDTH + static_cast<int>((cuckoo_random >> 1) % CUCKOO_BUCKET_WIDTH);
+        swap(carried, probing_table[slot]);
+        evictedFrom = bucket;
+    }
+    if (cuckoo_stash.size() < CUCKOO_STASH_SIZE)
+    {
+        cuckoo_stash.push_back(move(carried));
+        return true;
+    }
+    // The eviction chain ran too long and the stash is full; whichever entry is left over goes into a bigger table.
+    resizeAndRehash();
+    insertCuckoo(carried.key, carried.value);
+    return true;
+}
+
+template <typename T, typename K, typename Hasher>
+T* HashTable<T, K, Hasher>::searchCuckoo(const K& key, uint64_t hash)
+{
+    int slot = findCuckooSlot(key, hash);
+    if (slot >= 0)
+        return &probing_table[slot].value;
+    for (auto& entry : cuckoo_stash)
+        if (entry.key == key)
+            return &entry.value;
+    return nullptr;
+}
+
+template <typename T, typename K, typename Hasher>
+bool HashTable<T, K, Hasher>::removeCuckoo(const K& key)
+{
+    // No probe sequence runs through a slot, so it can simply become empty.
+    int slot = findCuckooSlot(key, hasher(key));
+    if (slot >= 0)
+    {
+        probing_table[slot] = KeyValuePair();
+        return true;
+    }
+    for (size_t i = 0; i < cuckoo_stash.size(); i++)
+    {
+        if (cuckoo_stash[i].key == key)
+        {
+            if (i + 1 != cuckoo_stash.size())
+                cuckoo_stash[i] = move(cuckoo_stash.back());
+            cuckoo_stash.pop_back();
+            return true;
+        }
+    }
+    return false;
 }
 
 // =======================
 // Separate Chaining Methods
 // =======================
-template <typename T>
-void HashTable<T>::insertSeparateChaining(int key, T value)
+template <typename T, typename K, typename Hasher>
+bool HashTable<T, K, Hasher>::insertSeparateChaining(const K& key, const T& value)
 {
-    
+    uint32_t& head = bucket_heads[hashFunction1(key)];
+    for (uint32_t i = head; i != CHAIN_END; i = chain_pool[i].next)
+    {
+        if (chain_pool[i].key == key)
+        {
+            chain_pool[i].value = value;
+            return false;
+        }
+    }
+    // New entries go to the front of the chain, in a free-listed slot if there is one.
+    uint32_t index = chain_free;
+    if (index != CHAIN_END)
+    {
+        chain_free = chain_pool[index].next;
+        chain_pool[index].key = key;
+        chain_pool[index].value = value;
+    }
+    else
+    {
+        index = static_cast<uint32_t>(chain_pool.size());
+        chain_pool.push_back(ChainEntry{key, value, CHAIN_END});
+    }
+    chain_pool[index].next = head;
+    head = index;
+    return true;
 }
 
-template <typename T>
-T HashTable<T>::searchSeparateChaining(int key)
+template <typename T, typename K, typename Hasher>
+T* HashTable<T, K, Hasher>::searchSeparateChaining(const K& key, uint64_t hash)
 {
-    return T();
+    for (uint32_t i = bucket_heads[hash & static_cast<uint64_t>(table_size - 1)]; i != CHAIN_END; i = chain_pool[i].next)
+        if (chain_pool[i].key == key)
+            return &chain_pool[i].value;
+    return nullptr;
 }
 
-template <typename T>
-void HashTable<T>::removeSeparateChaining(int key)
+template <typename T, typename K, typename Hasher>
+bool HashTable<T, K, Hasher>::removeSeparateChaining(const K& key)
 {
+    for (uint32_t* link = &bucket_heads[hashFunction1(key)]; *link != CHAIN_END; link = &chain_pool[*link].next)
+    {
+        uint32_t index = *link;
+        if (chain_pool[index].key == key)
+        {
+            *link = chain_pool[index].next;
+            chain_pool[index].key = K();
+            chain_pool[index].value = T();                  // release what the value holds (e.g. string storage) now.
+            chain_pool[index].next = chain_free;
+            chain_free = index;
+            return true;
+        }
+    }
+    return false;
+}
 
+template <typename T, typename K, typename Hasher>
+int HashTable<T, K, Hasher>::chainLength(int bucket) const
+{
+    int length = 0;
+    for (uint32_t i = bucket_heads[bucket]; i != CHAIN_END; i = chain_pool[i].next)
+        length++;
+    return length;
 }
 
 // =======================
-// Insert
+// Strategy Dispatch
 // =======================
-template <typename T>
-void HashTable<T>::insert(int key, T value)
+// These touch only this table's own arrays and leave num_elements alone; the public
+// methods below do the counting and consult the draining table during a migration.
+template <typename T, typename K, typename Hasher>
+bool HashTable<T, K, Hasher>::insertInto(const K& key, const T& value)
 {
     switch (collision_strategy)
     {
         case LINEAR_PROBING:
-            insertLinearProbing(key, value);
-            break;
+            return insertLinearProbing(key, value);
         case QUADRATIC_PROBING:
-            insertQuadraticProbing(key, value);
-            break;
+            return insertQuadraticProbing(key, value);
         case SEPARATE_CHAINING:
-            insertSeparateChaining(key, value);
-            break;
+            return insertSeparateChaining(key, value);
+        case ROBIN_HOOD:
+            return insertRobinHood(key, value);
+        case SWISS_TABLE:
+            return insertSwissTable(key, value);
+        case CUCKOO:
+            return insertCuckoo(key, value);
     }
-    calculateLoadFactor();
+    return false;
 }
 
-// =======================
-// Search
-// =======================
-template <typename T>
-T HashTable<T>::search(int key)
+template <typename T, typename K, typename Hasher>
+T* HashTable<T, K, Hasher>::findIn(const K& key, uint64_t hash)
+{
+    switch (collision_strategy)
+    {
+        case LINEAR_PROBING:
+            return searchLinearProbing(key, hash);
+        case QUADRATIC_PROBING:
+            return searchQuadraticProbing(key, hash);
+        case SEPARATE_CHAINING:
+            return searchSeparateChaining(key, hash);
+        case ROBIN_HOOD:
+            return searchRobinHood(key, hash);
+        case SWISS_TABLE:
+            return searchSwissTable(key, hash);
+        case CUCKOO:
+            return searchCuckoo(key, hash);
+    }
+    return nullptr;
+}
+
+template <typename T, typename K, typename Hasher>
+bool HashTable<T, K, Hasher>::removeFrom(const K& key)
 {
     switch (collision_strategy)
     {
         case LINEAR_PROBING:
-            return searchLinearProbing(key);
+            return removeLinearProbing(key);
         case QUADRATIC_PROBING:
-            return searchQuadraticProbing(key);
+            return removeQuadraticProbing(key);
         case SEPARATE_CHAINING:
-            return searchSeparateChaining(key);
+            return removeSeparateChaining(key);
+        case ROBIN_HOOD:
+            return removeRobinHood(key);
+        case SWISS_TABLE:
+            return removeSwissTable(key);
+        case CUCKOO:
+            return removeCuckoo(key);
     }
-    return T(); // Default return
+    return false;
+}
+
+// =======================
+// Insert
+// =======================
+template <typename T, typename K, typename Hasher>
+void HashTable<T, K, Hasher>::insert(const K& key, T value)
+{
+    migrateStep();
+    // Keep the two tables disjoint: a key still waiting in the old arrays moves over now.
+    if (draining && draining->removeFrom(key))
+        num_elements--;
+    if (instrumented)
+        stats.insertProbes[min(lookupProbes(key), HashTableStats::HISTOGRAM_BUCKETS - 1)]++;
+    if (insertInto(key, value))
+        num_elements++;
+    calculateLoadFactor();
+}
+
+// =======================
+// Search
+// =======================
+template <typename T, typename K, typename Hasher>
+T HashTable<T, K, Hasher>::search(const K& key)
+{
+    migrateStep();
+    uint64_t hash = hasher(key);
+    T* found = findIn(key, hash);
+    if (instrumented)
+    {
+        int probes = lookupProbes(key) + (!found && draining ? draining->lookupProbes(key) : 0);
+        stats.searchProbes[min(probes, HashTableStats::HISTOGRAM_BUCKETS - 1)]++;
+    }
+    if (!found && draining)
+        found = draining->findIn(key, hash);
+    return found ? *found : T(); // Default return
 }
 
 // =======================
 // Remove
 // =======================
-template <typename T>
-void HashTable<T>::remove(int key)
+template <typename T, typename K, typename Hasher>
+void HashTable<T, K, Hasher>::remove(const K& key)
+{
+    migrateStep();
+    if (removeFrom(key) || (draining && draining->removeFrom(key)))
+        num_elements--;
+    calculateLoadFactor();
+}
+
+// =======================
+// Batch Operations
+// =======================
+// One lookup at a time leaves the CPU waiting on each home slot's cache miss
+// before it can even start the next key. Hashing the whole batch up front lets
+// the slot for key i + prefetch_distance be requested while key i is probed,
+// so several misses are in flight at once.
+template <typename T, typename K, typename Hasher>
+void HashTable<T, K, Hasher>::prefetchHome(uint64_t hash) const
 {
+    uint64_t mask = static_cast<uint64_t>(table_size - 1);
     switch (collision_strategy)
     {
-        case LINEAR_PROBING:
-            removeLinearProbing(key);
+        case SEPARATE_CHAINING:
+            __builtin_prefetch(&bucket_heads[hash & mask]);
             break;
-        case QUADRATIC_PROBING:
-            removeQuadraticProbing(key);
+        case SWISS_TABLE:
+        {
+            int base = swissGroup(hash, 0) * GROUP_WIDTH;
+            __builtin_prefetch(control_bytes + base);
+            __builtin_prefetch(&probing_table[base]);
             break;
-        case SEPARATE_CHAINING:
-            removeSeparateChaining(key);
+        }
+        case CUCKOO:
+        {
+            int first, second;
+            cuckooBuckets(hash, first, second);
+            __builtin_prefetch(&probing_table[first * CUCKOO_BUCKET_WIDTH]);
+            __builtin_prefetch(&probing_table[second * CUCKOO_BUCKET_WIDTH]);
+            break;
+        }
+        default:
+            __builtin_prefetch(&probing_table[hash & mask]);
             break;
     }
-    calculateLoadFactor();
+}
+
+template <typename T, typename K, typename Hasher>
+void HashTable<T, K, Hasher>::searchBatch(const vector<K>& keys, vector<T>& outValues)
+{
+    size_t count = keys.size();
+    outValues.resize(count);
+    // A migration step or a histogram update belongs to every single search; take the plain path.
+    if (draining || instrumented)
+    {
+        for (size_t i = 0; i < count; i++)
+            outValues[i] = search(keys[i]);
+        return;
+    }
+    vector<uint64_t> hashes(count);
+    for (size_t i = 0; i < count; i++)
+        hashes[i] = hasher(keys[i]);
+    size_t distance = static_cast<size_t>(prefetch_distance);
+    size_t halfway = distance / 2;
+    uint64_t mask = static_cast<uint64_t>(table_size - 1);
+    for (size_t i = 0; i < min(distance, count); i++)
+        prefetchHome(hashes[i]);
+    for (size_t i = 0; i < count; i++)
+    {
+        if (i + distance < count)
+            prefetchHome(hashes[i + distance]);
+        // A chain is a second miss: its bucket head, requested half a distance ago, now says which entry to fetch.
+        if (collision_strategy == SEPARATE_CHAINING && halfway > 0 && i + halfway < count)
+        {
+            uint32_t head = bucket_heads[hashes[i + halfway] & mask];
+            if (head != CHAIN_END)
+                __builtin_prefetch(&chain_pool[head]);
+        }
+        T* found = findIn(keys[i], hashes[i]);
+        outValues[i] = found ? *found : T();
+    }
+}
+
+template <typename T, typename K, typename Hasher>
+void HashTable<T, K, Hasher>::insertBatch(const vector<K>& keys, const vector<T>& values)
+{
+    // Each insert still goes through insert() for counting, resizing and migration, and hashes its
+    // key again there; that is cheap next to the cache miss the prefetch hides.
+    size_t count = min(keys.size(), values.size());
+    vector<uint64_t> hashes(count);
+    for (size_t i = 0; i < count; i++)
+        hashes[i] = hasher(keys[i]);
+    size_t distance = static_cast<size_t>(prefetch_distance);
+    for (size_t i = 0; i < min(distance, count); i++)
+        prefetchHome(hashes[i]);
+    for (size_t i = 0; i < count; i++)
+    {
+        if (i + distance < count)
+            prefetchHome(hashes[i + distance]);
+        insert(keys[i], values[i]);
+    }
+}
+
+// =======================
+// Diagnostics
+// =======================
+template <typename T, typename K, typename Hasher>
+int HashTable<T, K, Hasher>::probeLengthOf(int slot) const
+{
+    if (collision_strategy == ROBIN_HOOD)
+        return probing_table[slot].probeDistance + 1;
+    if (collision_strategy == SWISS_TABLE)
+    {
+        // Counted in groups: each group is one tag comparison, however many slots it holds.
+        uint64_t hash = hasher(probing_table[slot].key);
+        int attempt = 0;
+        while (swissGroup(hash, attempt) != slot / GROUP_WIDTH)
+            attempt++;
+        return attempt + 1;
+    }
+    if (collision_strategy == CUCKOO)
+    {
+        int first, second;
+        cuckooBuckets(hasher(probing_table[slot].key), first, second);
+        return slot / CUCKOO_BUCKET_WIDTH == first ? 1 : 2;
+    }
+    int home = hashFunction1(probing_table[slot].key);
+    int attempt = 0;
+    while (probeSlot(home, attempt) != slot)
+        attempt++;
+    return attempt + 1;
+}
+
+// Walks the same path as the strategy's lookup, hit or miss; only called while instrumented.
+template <typename T, typename K, typename Hasher>
+int HashTable<T, K, Hasher>::lookupProbes(const K& key) const
+{
+    switch (collision_strategy)
+    {
+        case SEPARATE_CHAINING:
+        {
+            int length = 0;
+            for (uint32_t i = bucket_heads[hashFunction1(key)]; i != CHAIN_END; i = chain_pool[i].next)
+            {
+                length++;
+                if (chain_pool[i].key == key)
+                    break;
+            }
+            return length;
+        }
+        case CUCKOO:
+        {
+            int first, second;
+            uint64_t hash = hasher(key);
+            cuckooBuckets(hash, first, second);
+            int slot = findCuckooSlot(key, hash);
+            if (slot >= 0)
+                return slot / CUCKOO_BUCKET_WIDTH == first ? 1 : 2;
+            return cuckoo_stash.empty() ? 2 : 3;
+        }
+        case SWISS_TABLE:
+        {
+            uint64_t hash = hasher(key);
+            int8_t tag = swissTag(hash);
+            int groups = table_size / GROUP_WIDTH;
+            for (int attempt = 0; attempt < groups; attempt++)
+            {
+                int base = swissGroup(hash, attempt) * GROUP_WIDTH;
+                for (uint32_t match = matchGroup(control_bytes + base, tag); match; match &= match - 1)
+                    if (probing_table[base + __builtin_ctz(match)].key == key)
+                        return attempt + 1;
+                if (matchGroup(control_bytes + base, CONTROL_EMPTY))
+                    return attempt + 1;
+            }
+            return groups;
+        }
+        case ROBIN_HOOD:
+        {
+            int slot = hashFunction1(key);
+            int distance = 0;
+            while (probing_table[slot].isOccupied() && probing_table[slot].probeDistance >= distance && probing_table[slot].key != key)
+            {
+                slot = (slot + 1) & (table_size - 1);
+                distance++;
+            }
+            return distance + 1;
+        }
+        default:
+        {
+            int home = hashFunction1(key);
+            for (int attempt = 0; attempt < table_size; attempt++)
+            {
+                const KeyValuePair& entry = probing_table[probeSlot(home, attempt)];
+                if (entry.state == SLOT_EMPTY || (entry.isOccupied() && entry.key == key))
+                    return attempt + 1;
+            }
+            return table_size;
+        }
+    }
+}
+
+template <typename T, typename K, typename Hasher>
+HashTableStats HashTable<T, K, Hasher>::getStats()
+{
+    HashTableStats snapshot = stats;
+    snapshot.elements = num_elements;
+    snapshot.tableSize = table_size;
+    snapshot.tombstones = num_tombstones;
+    for (int bucket = 0; bucket < static_cast<int>(bucket_heads.size()); bucket++)
+    {
+        size_t length = chainLength(bucket);
+        if (snapshot.chainLengths.size() <= length)
+            snapshot.chainLengths.resize(length + 1);
+        snapshot.chainLengths[length]++;
+    }
+    return snapshot;
+}
+
+template <typename T, typename K, typename Hasher>
+double HashTable<T, K, Hasher>::averageProbeLength()
+{
+    long long total = 0;
+    long long entries = 0;                                  // this table only; a draining table is not counted.
+    if (collision_strategy == SEPARATE_CHAINING)
+    {
+        for (int bucket = 0; bucket < table_size; bucket++)
+        {
+            long long length = chainLength(bucket);
+            total += length * (length + 1) / 2;             // i-th entry costs i probes.
+            entries += length;
+        }
+    }
+    else
+    {
+        for (int i = 0; i < table_size; i++)
+        {
+            if (probing_table[i].isOccupied())
+            {
+                total += probeLengthOf(i);
+                entries++;
+            }
+        }
+    }
+    return entries == 0 ? 0.0 : static_cast<double>(total) / entries;
+}
+
+template <typename T, typename K, typename Hasher>
+int HashTable<T, K, Hasher>::maxProbeLength()
+{
+    int longest = 0;
+    if (collision_strategy == SEPARATE_CHAINING)
+    {
+        for (int bucket = 0; bucket < table_size; bucket++)
+            longest = max(longest, chainLength(bucket));
+    }
+    else
+    {
+        for (int i = 0; i < table_size; i++)
+            if (probing_table[i].isOccupied())
+                longest = max(longest, probeLengthOf(i));
+        if (!cuckoo_stash.empty())
+            longest = max(longest, 3);                      // both buckets, then the stash.
+    }
+    return longest;
 }
 
 // Please use this for debugging help
-template <typename T>
-void HashTable<T>::displayProbingTable()
+template <typename T, typename K, typename Hasher>
+void HashTable<T, K, Hasher>::displayProbingTable()
 {
     cout << "Current Table (size: " << table_size << "):\n";
+    if (collision_strategy == SEPARATE_CHAINING)
+    {
+        for (int i = 0; i < table_size; i++)
+        {
+            cout << "[" << i << "]";
+            for (uint32_t entry = bucket_heads[i]; entry != CHAIN_END; entry = chain_pool[entry].next)
+                cout << " -> (" << chain_pool[entry].key << ", " << chain_pool[entry].value << ")";
+            cout << endl;
+        }
+        return;
+    }
     for (int i = 0; i < table_size; i++)
     {
-        if (!probing_table[i].isEmpty)
+        if (probing_table[i].isOccupied())
             cout << "[" << i << "] -> Key: " << probing_table[i].key << ", Value: " << probing_table[i].value << endl;
+        else if (probing_table[i].state == SLOT_TOMBSTONE)
+            cout << "[" << i << "] -> TOMBSTONE\n";
         else
             cout << "[" << i << "] -> EMPTY\n";
     }
-}
\ No newline at end of file
+}
+
+// The table is compiled here rather than in the header, so every key/value/hasher combination in use is listed.
+template class HashTable<int>;
+template class HashTable<string>;
+template class HashTable<int, string>;
+template class HashTable<string, string>;
+template class HashTable<int, int, IdentityHash<int>>;
+template class HashTable<string, int, IdentityHash<int>>;
@@ -0,0 +1,695 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <functional>
+#include <unordered_map>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <new>
+#include <cstddef>
+#include <cstdlib>
+#include "HashTables.h"
+#include "ConcurrentHashTable.h"
+using namespace std;
+
+// Checks for the HashTable extensions beyond the graded interface (test_hash).
+// Not scored: the process exits with the number of failed checks.
+
+int failures = 0;
+
+// Live heap bytes, so memory per entry can be measured without external tools.
+// Each block carries its requested size in a header; no allocator-specific size query is needed.
+atomic<long long> heapBytes{0};
+const size_t HEAP_HEADER = alignof(max_align_t);
+
+void* operator new(size_t size)
+{
+    char* block = static_cast<char*>(malloc(HEAP_HEADER + size));
+    if (!block)
+        throw bad_alloc();
+    *reinterpret_cast<size_t*>(block) = size;
+    heapBytes += size;
+    return block + HEAP_HEADER;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    if (!ptr)
+        return;
+    char* block = static_cast<char*>(ptr) - HEAP_HEADER;
+    heapBytes -= *reinterpret_cast<size_t*>(block);
+    free(block);
+}
+
+void operator delete(void* block, size_t) noexcept
+{
+    operator delete(block);
+}
+
+long long histogramTotal(const long long (&histogram)[HashTableStats::HISTOGRAM_BUCKETS])
+{
+    long long total = 0;
+    for (long long count : histogram)
+        total += count;
+    return total;
+}
+
+double histogramMean(const long long (&histogram)[HashTableStats::HISTOGRAM_BUCKETS])
+{
+    long long weighted = 0;
+    for (int n = 0; n < HashTableStats::HISTOGRAM_BUCKETS; ++n)
+        weighted += n * histogram[n];
+    long long total = histogramTotal(histogram);
+    return total == 0 ? 0.0 : static_cast<double>(weighted) / total;
+}
+
+void check(const string& name, const function<bool()>& test)
+{
+    cout << "\033[1;34m" << name << ": \033[0m";
+    if (test())
+    {
+        cout << "\033[1;32mPassed!\033[0m" << endl;
+    }
+    else
+    {
+        cout << "\033[1;31mFailed!\033[0m" << endl;
+        failures++;
+    }
+}
+
+bool isPowerOfTwo(int n)
+{
+    return n > 0 && (n & (n - 1)) == 0;
+}
+
+// Random insert/update/remove/search mix, mirrored in unordered_map.
+// A striped table's total size is a sum of powers of two, hence powerOfTwoSize.
+template <typename Table>
+bool matchesModel(Table& table, int operations, int keyRange, unsigned seed, bool powerOfTwoSize = true)
+{
+    mt19937 rng(seed);
+    unordered_map<int, int> model;
+    for (int op = 0; op < operations; ++op)
+    {
+        int key = rng() % keyRange;
+        int choice = rng() % 10;
+        if (choice < 5)
+        {
+            int value = 1 + rng() % 1000000;
+            table.insert(key, value);
+            model[key] = value;
+        }
+        else if (choice < 8)
+        {
+            table.remove(key);
+            model.erase(key);
+        }
+        else
+        {
+            auto it = model.find(key);
+            if (table.search(key) != (it == model.end() ? 0 : it->second))
+                return false;
+        }
+        if (table.getNumberElements() != static_cast<int>(model.size()) || (powerOfTwoSize && !isPowerOfTwo(table.getTableSize())))
+            return false;
+    }
+    for (const auto& entry : model)
+        if (table.search(entry.first) != entry.second)
+            return false;
+    return true;
+}
+
+const CollisionHandle allStrategies[] = {LINEAR_PROBING, QUADRATIC_PROBING, SEPARATE_CHAINING, ROBIN_HOOD, SWISS_TABLE, CUCKOO};
+
+int main()
+{
+    cout << "\033[1;35m========================================\033[0m" << endl;
+    cout << "\033[1;35m   Hash Table Extension Checks \033[0m" << endl;
+    cout << "\033[1;35m========================================\033[0m" << endl;
+
+    check("Randomized operations match unordered_map (all strategies)", []()
+    {
+        for (CollisionHandle type : allStrategies)
+        {
+            HashTable<int> table(type);
+            if (!matchesModel(table, 20000, 3000, 11 + type))
+                return false;
+        }
+        return true;
+    });
+
+    check("String keys with string values", []()
+    {
+        for (CollisionHandle type : allStrategies)
+        {
+            HashTable<string, string> table(type);
+            for (int i = 0; i < 500; ++i)
+                table.insert("user" + to_string(i), "name" + to_string(i));
+            table.insert("user7", "renamed");
+            for (int i = 0; i < 500; i += 2)
+                table.remove("user" + to_string(i));
+            if (table.getNumberElements() != 250 || table.search("user7") != "renamed" || table.search("user8") != "")
+                return false;
+            for (int i = 1; i < 500; i += 2)
+                if (i != 7 && table.search("user" + to_string(i)) != "name" + to_string(i))
+                    return false;
+        }
+        return true;
+    });
+
+    check("Strided IDs: strong hash keeps probes short, identity hash clusters", []()
+    {
+        for (CollisionHandle type : allStrategies)
+        {
+            HashTable<int> strong(type);
+            HashTable<int, int, IdentityHash<int>> identity(type);
+            for (int i = 0; i < 20000; ++i)
+            {
+                strong.insert(i * 1024, i);
+                identity.insert(i * 1024, i);
+            }
+            double strongProbes = strong.averageProbeLength();
+            double identityProbes = identity.averageProbeLength();
+            cout << "[" << type << ": " << strongProbes << " vs " << identityProbes << "] ";
+            // SWISS_TABLE counts 16-slot groups rather than slots, so its clustering shows up as a smaller number.
+            // CUCKOO never needs more than two buckets; clustering shows as most keys pushed to their second one.
+            double clustered = type == SWISS_TABLE ? 2.0 : (type == CUCKOO ? 1.5 : 10.0);
+            if (strongProbes > 2.0 || identityProbes < clustered)
+                return false;
+        }
+        return true;
+    });
+
+    check("Robin Hood: same mean as linear probing, far shorter worst case", []()
+    {
+        // Same keys, both at load ~0.84: the mean is identical by construction, the spread is not.
+        HashTable<int> robin(ROBIN_HOOD);
+        HashTable<int> linear(LINEAR_PROBING);
+        mt19937 rng(5);
+        for (int i = 0; i < 55000; ++i)
+        {
+            int key = static_cast<int>(rng());
+            robin.insert(key, i);
+            linear.insert(key, i);
+        }
+        cout << "[robin avg " << robin.averageProbeLength() << " max " << robin.maxProbeLength()
+             << ", linear avg " << linear.averageProbeLength() << " max " << linear.maxProbeLength() << "] ";
+        if (robin.getTableSize() != linear.getTableSize() || robin.averageProbeLength() - linear.averageProbeLength() > 1e-9 ||
+            robin.maxProbeLength() * 2 > linear.maxProbeLength())
+            return false;
+        return true;
+    });
+
+    check("Robin Hood: runs above 0.9 load, deletes without markers", []()
+    {
+        HashTable<int> table(ROBIN_HOOD);
+        mt19937 rng(6);
+        vector<int> keys;
+        while (keys.size() < 50000 || static_cast<double>(table.getNumberElements()) / table.getTableSize() < 0.93)
+        {
+            keys.push_back(static_cast<int>(rng()));
+            table.insert(keys.back(), keys.size());
+        }
+        double average = table.averageProbeLength();
+        cout << "[load " << static_cast<double>(table.getNumberElements()) / table.getTableSize()
+             << ", avg " << average << ", max " << table.maxProbeLength() << "] ";
+        if (table.maxProbeLength() > 128)
+            return false;
+        // Backward-shift deletion leaves no markers behind, so removing half the keys shortens the remaining probes.
+        int size = table.getTableSize();
+        for (size_t i = 0; i < keys.size(); i += 2)
+            table.remove(keys[i]);
+        for (size_t i = 1; i < keys.size(); i += 2)
+            if (table.search(keys[i]) != static_cast<int>(i + 1))
+                return false;
+        return table.getTableSize() == size && table.averageProbeLength() < average / 2;
+    });
+
+    check("Cuckoo: lookups touch at most two buckets up to 0.9 load", []()
+    {
+        HashTable<int> table(CUCKOO);
+        vector<int> keys;
+        double peakLoad = 0;
+        int maxProbes = 0;
+        for (int i = 0; i < 200000; ++i)
+        {
+            keys.push_back(static_cast<int>(i * 2654435761u));     // distinct: an odd multiplier is a bijection.
+            table.insert(keys.back(), i + 1);
+            peakLoad = max(peakLoad, static_cast<double>(table.getNumberElements()) / table.getTableSize());
+            if (i % 1000 == 999)
+                maxProbes = max(maxProbes, table.maxProbeLength());
+        }
+        cout << "[peak load " << peakLoad << ", avg " << table.averageProbeLength() << " buckets, max " << maxProbes << "] ";
+        // 3 means a key sat in the stash, which is searched after both buckets.
+        if (peakLoad < 0.85 || maxProbes > 3 || table.getNumberTombstones() != 0)
+            return false;
+        for (size_t i = 0; i < keys.size(); i += 2)
+            table.remove(keys[i]);
+        for (size_t i = 0; i < keys.size(); ++i)
+            if (table.search(keys[i]) != (i % 2 == 0 ? 0 : static_cast<int>(i + 1)))
+                return false;
+        return table.getNumberTombstones() == 0;
+    });
+
+    check("Tombstones: counted apart from elements, reused by inserts", []()
+    {
+        for (CollisionHandle type : {LINEAR_PROBING, QUADRATIC_PROBING})
+        {
+            // 100 keys in 128 slots; 20 tombstones stay under the cleanup threshold.
+            HashTable<int> table(type);
+            for (int i = 0; i < 100; ++i)
+                table.insert(i, i + 1);
+            for (int i = 0; i < 20; ++i)
+                table.remove(i);
+            table.remove(1000);
+            if (table.getTableSize() != 128 || table.getNumberElements() != 80 || table.getNumberTombstones() != 20)
+                return false;
+            for (int i = 0; i < 20; ++i)
+                table.insert(i, i + 1);
+            // Each re-inserted key takes the first tombstone on its own path, which need not be its old slot.
+            if (table.getNumberElements() != 100 || table.getNumberTombstones() > 20 || table.search(3) != 4)
+                return false;
+        }
+        HashTable<int> robin(ROBIN_HOOD), chained(SEPARATE_CHAINING);
+        for (int i = 0; i < 1000; ++i)
+        {
+            robin.insert(i, i);
+            chained.insert(i, i);
+        }
+        for (int i = 0; i < 1000; i += 2)
+        {
+            robin.remove(i);
+            chained.remove(i);
+        }
+        return robin.getNumberTombstones() == 0 && chained.getNumberTombstones() == 0;
+    });
+
+    check("Tombstones: delete-heavy churn is cleaned up at a fixed table size", []()
+    {
+        for (CollisionHandle type : {LINEAR_PROBING, QUADRATIC_PROBING, SWISS_TABLE})
+        {
+            // A session table: about 5000 live keys, each removed soon after it arrives and replaced by a new one.
+            HashTable<int> table(type);
+            mt19937 rng(31 + type);
+            vector<int> live;
+            for (int i = 0; i < 5000; ++i)
+            {
+                live.push_back(static_cast<int>(rng()));
+                table.insert(live.back(), i + 1);
+            }
+            int size = table.getTableSize();
+            int peakTombstones = 0;
+            for (int op = 0; op < 200000; ++op)
+            {
+                size_t victim = rng() % live.size();
+                table.remove(live[victim]);
+                live[victim] = static_cast<int>(rng());
+                table.insert(live[victim], 1);
+                peakTombstones = max(peakTombstones, table.getNumberTombstones());
+            }
+            cout << "[" << type << ": peak " << peakTombstones << " tombstones in " << table.getTableSize() << " slots] ";
+            if (table.getTableSize() != size || peakTombstones > 0.2 * size + 1 ||
+                table.getNumberElements() != static_cast<int>(live.size()))
+                return false;
+            for (int key : live)
+                if (table.search(key) == 0)
+                    return false;
+        }
+        return true;
+    });
+
+    check("Tombstones: churn right at the load threshold does not purge on every insert", []()
+    {
+        for (CollisionHandle type : {LINEAR_PROBING, QUADRATIC_PROBING, SWISS_TABLE})
+        {
+            // Fill until one more insert would grow the table, then replace keys one at a time.
+            HashTable<int> table(type);
+            int next = 0;
+            while (table.getTableSize() < 2048 || table.getNumberElements() + 1 <= 0.85 * table.getTableSize())
+            {
+                table.insert(next, next + 1);
+                ++next;
+            }
+            table.resetStats();
+            int oldest = 0;
+            for (int op = 0; op < 1000; ++op)
+            {
+                table.remove(oldest++);
+                table.insert(next, next + 1);
+                ++next;
+            }
+            HashTableStats stats = table.getStats();
+            cout << "[" << type << ": " << stats.tombstonePurges << " purges, " << stats.resizes << " resizes] ";
+            if (stats.tombstonePurges > 10 || stats.resizes > 1)
+                return false;
+            for (int key = oldest; key < next; ++key)
+                if (table.search(key) != key + 1)
+                    return false;
+        }
+        return true;
+    });
+
+    check("Incremental rehash: operations stay correct mid-migration (all strategies)", []()
+    {
+        for (CollisionHandle type : allStrategies)
+        {
+            // One bucket per operation keeps a migration in flight for most of the run.
+            HashTable<int> table(type);
+            table.setIncrementalRehash(true, 1);
+            bool sawMigration = false;
+            mt19937 rng(21 + type);
+            unordered_map<int, int> model;
+            for (int op = 0; op < 30000; ++op)
+            {
+                int key = rng() % 20000;
+                if (rng() % 4 != 0)
+                {
+                    table.insert(key, op + 1);
+                    model[key] = op + 1;
+                }
+                else
+                {
+                    table.remove(key);
+                    model.erase(key);
+                }
+                sawMigration = sawMigration || table.isRehashing();
+                int probe = rng() % 20000;
+                auto it = model.find(probe);
+                if (table.search(probe) != (it == model.end() ? 0 : it->second) ||
+                    table.getNumberElements() != static_cast<int>(model.size()))
+                    return false;
+            }
+            if (!sawMigration)
+                return false;
+        }
+        return true;
+    });
+
+    check("Incremental rehash: no insert does more than a step of work", []()
+    {
+        // Work is slots initialised plus entries moved. int/int arrays come zeroed from calloc, so a
+        // migration only costs its steps; a stop-the-world resize moves the whole table in one insert.
+        auto worstInsert = [](CollisionHandle type, bool incremental, long long& initialized)
+        {
+            HashTable<int> table(type);
+            table.setIncrementalRehash(incremental);
+            long long worst = 0, done = 0;
+            for (int i = 0; i < 200000; ++i)
+            {
+                table.insert(i, i);
+                HashTableStats stats = table.getStats();
+                worst = max(worst, stats.slotsInitialized + stats.entriesMoved - done);
+                done = stats.slotsInitialized + stats.entriesMoved;
+            }
+            initialized = table.getStats().slotsInitialized;
+            return worst;
+        };
+        for (CollisionHandle type : {LINEAR_PROBING, QUADRATIC_PROBING, ROBIN_HOOD, SWISS_TABLE, CUCKOO})
+        {
+            long long initialized, unused;
+            long long incremental = worstInsert(type, true, initialized);
+            long long stopTheWorld = worstInsert(type, false, unused);
+            cout << "[" << type << ": " << incremental << " vs " << stopTheWorld << "] ";
+            if (incremental > 64 || stopTheWorld < 100000 || initialized != 0)
+                return false;
+        }
+        return true;
+    });
+
+    check("Stats: probe histograms tell a bad hash from a bad load factor", []()
+    {
+        // Same strided keys and load: only the hash differs, and the search histogram shows it.
+        HashTable<int> strong(LINEAR_PROBING);
+        HashTable<int, int, IdentityHash<int>> identity(LINEAR_PROBING);
+        strong.setInstrumentation(true);
+        identity.setInstrumentation(true);
+        for (int i = 0; i < 5000; ++i)
+        {
+            strong.insert(i * 1024, i + 1);
+            identity.insert(i * 1024, i + 1);
+        }
+        for (int i = 0; i < 10000; ++i)
+        {
+            strong.search(i * 1024);
+            identity.search(i * 1024);
+        }
+        HashTableStats good = strong.getStats(), bad = identity.getStats();
+        cout << "[mean search probes " << histogramMean(good.searchProbes) << " vs " << histogramMean(bad.searchProbes)
+             << ", " << good.resizes << " resizes, " << good.rehashMilliseconds << "ms rehashing] ";
+        if (histogramTotal(good.insertProbes) != 5000 || histogramTotal(good.searchProbes) != 10000 ||
+            good.resizes != bad.resizes || good.tableSize != 8192 || good.resizes != 9 || good.rehashMilliseconds <= 0)
+            return false;
+        if (histogramMean(good.searchProbes) > 3 || bad.searchProbes[HashTableStats::HISTOGRAM_BUCKETS - 1] < 5000)
+            return false;
+        // Without instrumentation only the cheap counters move.
+        HashTable<int> quiet(LINEAR_PROBING);
+        for (int i = 0; i < 100; ++i)
+            quiet.insert(i, i);
+        quiet.search(5);
+        HashTableStats silent = quiet.getStats();
+        return histogramTotal(silent.insertProbes) == 0 && histogramTotal(silent.searchProbes) == 0 && silent.resizes == 3;
+    });
+
+    check("Stats: chain lengths, tombstones and purges", []()
+    {
+        HashTable<int> chained(SEPARATE_CHAINING);
+        for (int i = 0; i < 3000; ++i)
+            chained.insert(i, i);
+        HashTableStats chains = chained.getStats();
+        long long buckets = 0, entries = 0;
+        for (size_t n = 0; n < chains.chainLengths.size(); ++n)
+        {
+            buckets += chains.chainLengths[n];
+            entries += n * chains.chainLengths[n];
+        }
+        if (buckets != chains.tableSize || entries != 3000 || chains.chainLengths.size() > 12)
+            return false;
+
+        HashTable<int> probing(QUADRATIC_PROBING);
+        for (int i = 0; i < 100; ++i)
+            probing.insert(i, i);
+        for (int i = 0; i < 20; ++i)
+            probing.remove(i);
+        if (probing.getStats().tombstones != 20 || probing.getStats().tombstonePurges != 0)
+            return false;
+        for (int i = 20; i < 40; ++i)
+            probing.remove(i);
+        HashTableStats purged = probing.getStats();
+        probing.resetStats();
+        return purged.tombstonePurges == 1 && purged.tombstones < 20 && probing.getStats().resizes == 0;
+    });
+
+    check("Chaining: entries live in one pool, about 20 bytes each", []()
+    {
+        const int count = 1000000;
+        long long before = heapBytes;
+        double bytesPerEntry;
+        {
+            HashTable<int> table(SEPARATE_CHAINING);
+            for (int i = 0; i < count; ++i)
+                table.insert(i, i);
+            bytesPerEntry = static_cast<double>(heapBytes - before) / count;
+            // Freed entries are reused rather than appended.
+            for (int i = 0; i < count; i += 2)
+                table.remove(i);
+            long long afterRemoves = heapBytes;
+            for (int i = 0; i < count; i += 2)
+                table.insert(i, i + 1);
+            if (heapBytes != afterRemoves || table.getNumberElements() != count || table.search(4) != 5 || table.search(5) != 5)
+                return false;
+        }
+        cout << "[" << bytesPerEntry << " bytes per int/int entry] ";
+        // 4-byte bucket head per slot at load <= 0.85, plus a 12-byte pooled entry and vector slack.
+        return bytesPerEntry < 32 && heapBytes == before;
+    });
+
+    check("Batch operations match per-key results (all strategies, mid-migration too)", []()
+    {
+        for (CollisionHandle type : allStrategies)
+        {
+            for (bool incremental : {false, true})
+            {
+                HashTable<int> batched(type), single(type);
+                batched.setIncrementalRehash(incremental, 1);
+                vector<int> keys, values;
+                for (int i = 0; i < 30000; ++i)
+                {
+                    keys.push_back(static_cast<int>(i * 2654435761u));
+                    values.push_back(i + 1);
+                    single.insert(keys.back(), values.back());
+                }
+                batched.insertBatch(keys, values);
+                // Every other query misses, and a short batch is smaller than the prefetch distance.
+                vector<int> queries;
+                for (int i = 0; i < 20000; ++i)
+                    queries.push_back(i % 2 ? keys[(i * 7) % keys.size()] : -i);
+                vector<int> found, few;
+                batched.searchBatch(queries, found);
+                batched.searchBatch(vector<int>(queries.begin(), queries.begin() + 3), few);
+                if (batched.getNumberElements() != single.getNumberElements() || found.size() != queries.size() || few.size() != 3)
+                    return false;
+                for (size_t i = 0; i < queries.size(); ++i)
+                    if (found[i] != single.search(queries[i]) || (i < 3 && few[i] != found[i]))
+                        return false;
+            }
+        }
+        return true;
+    });
+
+    check("Batch search: prefetching overlaps cache misses on a large table", []()
+    {
+        using namespace chrono;
+        for (CollisionHandle type : {LINEAR_PROBING, SEPARATE_CHAINING, SWISS_TABLE})
+        {
+            HashTable<int> table(type);
+            const int count = 1000000;
+            vector<int> keys(count), values(count), queries(count);
+            for (int i = 0; i < count; ++i)
+            {
+                keys[i] = static_cast<int>(i * 2654435761u);
+                values[i] = i + 1;
+            }
+            table.insertBatch(keys, values);
+            mt19937 rng(71);
+            for (int& query : queries)
+                query = keys[rng() % count];
+            auto start = steady_clock::now();
+            long long perKeySum = 0;
+            for (int query : queries)
+                perKeySum += table.search(query);
+            double perKey = duration<double, milli>(steady_clock::now() - start).count();
+            vector<int> found;
+            start = steady_clock::now();
+            table.searchBatch(queries, found);
+            double batch = duration<double, milli>(steady_clock::now() - start).count();
+            long long batchSum = 0;
+            for (int value : found)
+                batchSum += value;
+            cout << "[" << type << ": " << perKey << "ms per key, " << batch << "ms batched] ";
+            // Timing depends on the machine; the numbers are reported, only the results are checked.
+            if (batchSum != perKeySum)
+                return false;
+        }
+        return true;
+    });
+
+    check("Concurrent table: single-threaded behaviour matches HashTable", []()
+    {
+        ConcurrentHashTable<int> table;
+        return matchesModel(table, 50000, 5000, 41, false);
+    });
+
+    check("Concurrent table: writers on every stripe, readers never see a foreign value", []()
+    {
+        // Writer w owns keys with key % writers == w and stores (round << 32) | key, so a reader can tell
+        // a value that belongs to its key from one torn or misplaced by a concurrent resize.
+        const int writers = 4, readers = 4, keysPerWriter = 20000, rounds = 3;
+        ConcurrentHashTable<long long> table;
+        atomic<bool> done{false};
+        atomic<long long> badReads{0}, reads{0};
+        vector<thread> threads;
+        for (int w = 0; w < writers; ++w)
+        {
+            threads.emplace_back([&, w]()
+            {
+                for (long long round = 1; round <= rounds; ++round)
+                {
+                    for (int i = 0; i < keysPerWriter; ++i)
+                    {
+                        int key = i * writers + w;
+                        table.insert(key, (round << 32) | key);
+                    }
+                    for (int i = 0; i < keysPerWriter; i += 3)
+                        table.remove(i * writers + w);
+                }
+            });
+        }
+        for (int r = 0; r < readers; ++r)
+        {
+            threads.emplace_back([&, r]()
+            {
+                mt19937 rng(51 + r);
+                long long local = 0;
+                while (!done.load())
+                {
+                    int key = rng() % (writers * keysPerWriter);
+                    long long value = table.search(key);
+                    if (value != 0 && ((value & 0xffffffffLL) != key || (value >> 32) < 1 || (value >> 32) > rounds))
+                        badReads++;
+                    local++;
+                }
+                reads += local;
+            });
+        }
+        for (int w = 0; w < writers; ++w)
+            threads[w].join();
+        done = true;
+        for (int r = 0; r < readers; ++r)
+            threads[writers + r].join();
+        cout << "[" << reads.load() << " concurrent reads, " << badReads.load() << " bad] ";
+        if (badReads != 0)
+            return false;
+        int expected = 0;
+        for (int key = 0; key < writers * keysPerWriter; ++key)
+        {
+            bool removed = (key / writers) % 3 == 0;
+            long long value = table.search(key);
+            if (value != (removed ? 0 : (static_cast<long long>(rounds) << 32 | key)))
+                return false;
+            expected += removed ? 0 : 1;
+        }
+        return table.getNumberElements() == expected;
+    });
+
+    check("Concurrent table: replaced arrays are freed while searches keep running", []()
+    {
+        // Every key shares the hot key's stripe, so searches are always in flight there while it rehashes.
+        StrongHash<int> hash;
+        vector<int> keys;
+        for (int key = 0; keys.size() < 60000; ++key)
+            if (hash(key) >> 58 == hash(0) >> 58)
+                keys.push_back(key);
+        const int live = 100;
+        ConcurrentHashTable<int> table;
+        for (int i = 0; i < live; ++i)
+            table.insert(keys[i], i + 1);
+        atomic<bool> done{false};
+        atomic<long long> badReads{0};
+        vector<thread> readers;
+        for (int r = 0; r < 8; ++r)
+        {
+            readers.emplace_back([&]()
+            {
+                while (!done.load())
+                    if (table.search(keys[0]) != 1)
+                        badReads++;
+            });
+        }
+        // Each remove leaves a tombstone, so the stripe is rebuilt every few pairs.
+        const int pairs = static_cast<int>(keys.size()) - live;
+        int peak = 0, lateLow = INT32_MAX;
+        for (int i = 1; i < pairs; ++i)
+        {
+            table.remove(keys[i]);
+            table.insert(keys[i + live - 1], 1);
+            if (i % 64 == 0)
+            {
+                int pending = table.getRetiredArrays();
+                peak = max(peak, pending);
+                if (i > pairs / 2)
+                    lateLow = min(lateLow, pending);
+            }
+        }
+        done = true;
+        for (thread& reader : readers)
+            reader.join();
+        cout << "[peak " << peak << " retired arrays, low " << lateLow << " in the second half] ";
+        return badReads == 0 && lateLow <= 2 && table.getNumberElements() == live;
+    });
+
+    cout << "\033[1;35m========================================\033[0m" << endl;
+    cout << (failures == 0 ? "\033[1;32mAll extension checks passed.\033[0m" : "\033[1;31mSome extension checks failed.\033[0m") << endl;
+    return failures;
+}